@@ -0,0 +1,94 @@
+/*
+ *  LTC2983ChannelSet.h
+ *  Bitmask type for sets of LTC2983 channels
+ *  October 2026
+ *
+ *  Bit n of the mask is channel n (bit 0 is unused, like index 0 of the channel
+ *  arrays); FromBits() builds a set from such a mask and ToChipMask() gives the layout
+ *  of the chip's multiple channel mask register. There is no implicit conversion from
+ *  an integer, which would make MeasureChannels(5) mean channel 2 rather than 5.
+ *  Iteration visits only the members, lowest channel first, using count-trailing-zeros:
+ *
+ *      for (uint8_t channel : set) { ... }
+ *
+ *  or, consuming a copy:
+ *
+ *      while (!set.Empty()) { uint8_t channel = set.PopFirst(); ... }
+ */
+
+#ifndef LTC2983CHANNELSET_H
+#define LTC2983CHANNELSET_H
+
+#include <stdint.h>
+
+#define CHANNEL_SET_ALL_BITS	(uint32_t) 0x1FFFFE // channels 1-20
+
+class LTC2983ChannelSet {
+public:
+	LTC2983ChannelSet(void) : _bits(0) { }
+	explicit LTC2983ChannelSet(uint32_t bits) : _bits(bits & CHANNEL_SET_ALL_BITS) { }
+
+	// construction
+	static LTC2983ChannelSet All(void) { return LTC2983ChannelSet(CHANNEL_SET_ALL_BITS); }
+	static LTC2983ChannelSet None(void) { return LTC2983ChannelSet(); }
+	static LTC2983ChannelSet Single(uint8_t channel_number) { return LTC2983ChannelSet(Bit(channel_number)); }
+	static LTC2983ChannelSet Range(uint8_t first_channel, uint8_t last_channel) {
+		if (first_channel > last_channel || last_channel > 31) return LTC2983ChannelSet();
+		return LTC2983ChannelSet(((uint32_t) 0xFFFFFFFF >> (31 - last_channel)) & ((uint32_t) 0xFFFFFFFF << first_channel));
+	}
+	static LTC2983ChannelSet FromBits(uint32_t bits) { return LTC2983ChannelSet(bits); }
+	static LTC2983ChannelSet FromChipMask(uint32_t chip_mask) { return LTC2983ChannelSet(chip_mask << 1); }
+
+	// membership
+	void Add(uint8_t channel_number) { _bits |= Bit(channel_number) & CHANNEL_SET_ALL_BITS; }
+	void Remove(uint8_t channel_number) { _bits &= ~Bit(channel_number); }
+	bool Contains(uint8_t channel_number) const { return (_bits & Bit(channel_number)) != 0; }
+	bool Empty(void) const { return _bits == 0; }
+	uint8_t Count(void) const { return (uint8_t) __builtin_popcount(_bits); }
+
+	// lowest and highest channel, 0 if the set is empty
+	uint8_t First(void) const { return _bits ? (uint8_t) __builtin_ctz(_bits) : 0; }
+	uint8_t Last(void) const { return _bits ? (uint8_t) (31 - __builtin_clz(_bits)) : 0; }
+	uint8_t PopFirst(void) {
+		uint8_t channel_number = First();
+		_bits &= _bits - 1; // clear the lowest set bit
+		return channel_number;
+	}
+
+	// set algebra
+	LTC2983ChannelSet operator|(const LTC2983ChannelSet & other) const { return LTC2983ChannelSet(_bits | other._bits); }
+	LTC2983ChannelSet operator&(const LTC2983ChannelSet & other) const { return LTC2983ChannelSet(_bits & other._bits); }
+	LTC2983ChannelSet operator^(const LTC2983ChannelSet & other) const { return LTC2983ChannelSet(_bits ^ other._bits); }
+	LTC2983ChannelSet operator-(const LTC2983ChannelSet & other) const { return LTC2983ChannelSet(_bits & ~other._bits); }
+	LTC2983ChannelSet operator~(void) const { return LTC2983ChannelSet(~_bits); }
+	LTC2983ChannelSet & operator|=(const LTC2983ChannelSet & other) { _bits |= other._bits; return *this; }
+	LTC2983ChannelSet & operator&=(const LTC2983ChannelSet & other) { _bits &= other._bits; return *this; }
+	LTC2983ChannelSet & operator-=(const LTC2983ChannelSet & other) { _bits &= ~other._bits; return *this; }
+	bool operator==(const LTC2983ChannelSet & other) const { return _bits == other._bits; }
+	bool operator!=(const LTC2983ChannelSet & other) const { return _bits != other._bits; }
+
+	// raw masks
+	uint32_t Bits(void) const { return _bits; }
+	uint32_t ToChipMask(void) const { return _bits >> 1; } // channel 1 in bit 0
+
+	// iteration over members, lowest channel first
+	class Iterator {
+	public:
+		Iterator(uint32_t bits) : _remaining(bits) { }
+		uint8_t operator*(void) const { return (uint8_t) __builtin_ctz(_remaining); }
+		Iterator & operator++(void) { _remaining &= _remaining - 1; return *this; }
+		bool operator!=(const Iterator & other) const { return _remaining != other._remaining; }
+	private:
+		uint32_t _remaining;
+	};
+
+	Iterator begin(void) const { return Iterator(_bits); }
+	Iterator end(void) const { return Iterator(0); }
+
+private:
+	static uint32_t Bit(uint8_t channel_number) { return channel_number < 32 ? (uint32_t) 1 << channel_number : 0; }
+
+	uint32_t _bits;
+};
+
+#endif
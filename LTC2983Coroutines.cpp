@@ -0,0 +1,140 @@
+/*
+ *  LTC2983Coroutines.cpp
+ *  C++20 coroutine interface to LTC2983Manager
+ *  October 2026
+ *
+ *  See LTC2983Coroutines.h for usage.
+ */
+
+#include "LTC2983Coroutines.h"
+
+#ifdef LTC2983_COROUTINES
+
+// LTC2983MeasureAwaiter ------------------------------------------------------
+LTC2983MeasureAwaiter::LTC2983MeasureAwaiter(LTC2983AsyncManager * chip, uint8_t channel_number) {
+	_chip = chip;
+	_channel = channel_number;
+	_result = TEMPERATURE_ERROR;
+	_elapsed_us = 0;
+	_next = nullptr;
+}
+
+// channels that would not produce a temperature complete without suspending
+bool LTC2983MeasureAwaiter::await_ready(void) {
+	if (_channel < 1 || _channel > 20) return true;
+
+	Sensor_Type_t assignment = _chip->Manager()->channel_assignments[_channel];
+	return (assignment != THERMISTOR_44006 && assignment != RTD_PT_100);
+}
+
+void LTC2983MeasureAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	_handle = handle;
+	_chip->Enqueue(this);
+}
+
+// LTC2983AsyncManager --------------------------------------------------------
+LTC2983AsyncManager::LTC2983AsyncManager(LTC2983Manager * manager, LTC2983EventLoop * loop, bool use_interrupt) {
+	_manager = manager;
+	_loop = loop;
+	_use_interrupt = use_interrupt;
+	_converting = false;
+	_start_us = 0;
+	_head = nullptr;
+	_tail = nullptr;
+	_next_chip = nullptr;
+
+	_loop->Register(this);
+}
+
+LTC2983AsyncManager::~LTC2983AsyncManager(void) {
+	_loop->Unregister(this);
+}
+
+// Only the channels' own conversion times are summed for learning, so measurements
+// other coroutines queue in between do not count against the sweep
+LTC2983Task LTC2983AsyncManager::Sweep(LTC2983ChannelSet channels) {
+	uint32_t elapsed_us = 0;
+	uint8_t conversions = 0;
+
+	for (uint8_t channel : channels) {
+		LTC2983MeasureAwaiter measurement = MeasureChannel(channel);
+		co_await measurement;
+
+		if (measurement._elapsed_us > 0) {
+			elapsed_us += measurement._elapsed_us;
+			conversions++;
+		}
+	}
+
+	_manager->FinishSweep(elapsed_us, conversions);
+}
+
+void LTC2983AsyncManager::Enqueue(LTC2983MeasureAwaiter * awaiter) {
+	awaiter->_next = nullptr;
+	if (_tail == nullptr) {
+		_head = awaiter;
+	} else {
+		_tail->_next = awaiter;
+	}
+	_tail = awaiter;
+}
+
+bool LTC2983AsyncManager::Poll(void) {
+	if (_head == nullptr) return false;
+
+	LTC2983MeasureAwaiter * awaiter = _head;
+
+	if (!_converting) {
+		if (_manager->Sleeping()) _manager->WakeUp();
+		_start_us = micros();
+		_manager->StartMeasurement(awaiter->_channel);
+		_converting = true;
+		return true;
+	}
+
+	// the interrupt flag is free to check, the status register costs a bus transfer
+	if (_use_interrupt && !_manager->InterruptPending()) return true;
+	if (!_manager->FinishedMeasurement()) return true;
+
+	awaiter->_elapsed_us = micros() - _start_us;
+	awaiter->_result = _manager->ReadMeasurementResult(awaiter->_channel);
+	_converting = false;
+
+	// dequeue before resuming, the coroutine may queue its next measurement right away
+	_head = awaiter->_next;
+	if (_head == nullptr) _tail = nullptr;
+	awaiter->_handle.resume();
+
+	return true;
+}
+
+// LTC2983EventLoop -----------------------------------------------------------
+bool LTC2983EventLoop::Poll(void) {
+	bool pending = false;
+	LTC2983AsyncManager * chip;
+
+	for (chip = _chips; chip != nullptr; chip = chip->_next_chip) {
+		if (chip->Poll()) pending = true;
+	}
+
+	return pending;
+}
+
+void LTC2983EventLoop::Register(LTC2983AsyncManager * chip) {
+	chip->_next_chip = _chips;
+	_chips = chip;
+}
+
+void LTC2983EventLoop::Unregister(LTC2983AsyncManager * chip) {
+	LTC2983AsyncManager ** link = &_chips;
+
+	while (*link != nullptr) {
+		if (*link == chip) {
+			*link = chip->_next_chip;
+			return;
+		}
+		link = &(*link)->_next_chip;
+	}
+}
+
+#endif // LTC2983_COROUTINES
@@ -0,0 +1,171 @@
+/*
+ *  LTC2983Coroutines.h
+ *  C++20 coroutine interface to LTC2983Manager
+ *  October 2026
+ *
+ *  Wraps the non-blocking StartMeasurement()/FinishedMeasurement() split so that
+ *  measurements can be awaited instead of blocking a thread:
+ *
+ *      LTC2983EventLoop loop;
+ *      LTC2983AsyncManager chip(&manager, &loop);
+ *
+ *      LTC2983Task Logger(void) {
+ *          float t = co_await chip.MeasureChannel(4);
+ *          co_await chip.Sweep(LTC2983ChannelSet::All());
+ *      }
+ *
+ *      LTC2983Task task = Logger();
+ *      task.Start();
+ *      loop.Run(); // or call loop.Poll() from an existing event loop or timer
+ *
+ *  The event loop is the completion source: each Poll() checks every chip with a
+ *  measurement in flight (the interrupt flag if the chip's INTERRUPT pin calls
+ *  InterruptHandler(), otherwise the status register), reads finished results
+ *  through the normal result path and resumes the waiting coroutine. Any number of
+ *  coroutines may await the same chip; their measurements are queued and run one at a
+ *  time in request order, while different chips convert concurrently.
+ *
+ *  A Sweep() ends with the manager's end-of-sweep work, like LTC2983Manager::MeasureSweep().
+ *
+ *  Note: only available when compiling as C++20 with <coroutine>, the rest of the
+ *        library does not depend on this file. Like the manager it needs the Arduino
+ *        core. Coroutine frames are heap allocated.
+ */
+
+#ifndef LTC2983COROUTINES_H
+#define LTC2983COROUTINES_H
+
+#if defined(__cplusplus) && __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<coroutine>)
+#define LTC2983_COROUTINES 1
+#endif
+#endif
+
+#ifdef LTC2983_COROUTINES
+
+#include "LTC2983Manager.h"
+#include <coroutine>
+#include <exception>
+
+class LTC2983EventLoop;
+class LTC2983AsyncManager;
+
+// Awaitable for a single conversion, queued on its chip while suspended
+class LTC2983MeasureAwaiter {
+public:
+	LTC2983MeasureAwaiter(LTC2983AsyncManager * chip, uint8_t channel_number);
+
+	bool await_ready(void);
+	void await_suspend(std::coroutine_handle<> handle);
+	float await_resume(void) { return _result; }
+
+private:
+	friend class LTC2983AsyncManager;
+
+	LTC2983AsyncManager * _chip;
+	uint8_t _channel;
+	float _result;
+	uint32_t _elapsed_us; // from the start command to the poll that saw it done, 0 if not converted
+	std::coroutine_handle<> _handle;
+	LTC2983MeasureAwaiter * _next;
+};
+
+// Lazily started coroutine that can itself be awaited, used for Sweep() and for
+// user tasks. Destroying the task destroys the coroutine frame.
+class LTC2983Task {
+public:
+	struct promise_type {
+		std::coroutine_handle<> continuation;
+
+		struct FinalAwaiter {
+			bool await_ready(void) noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+				std::coroutine_handle<> next = handle.promise().continuation;
+				return next ? next : std::noop_coroutine();
+			}
+			void await_resume(void) noexcept { }
+		};
+
+		LTC2983Task get_return_object(void) { return LTC2983Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend(void) noexcept { return {}; }
+		FinalAwaiter final_suspend(void) noexcept { return {}; }
+		void return_void(void) { }
+		void unhandled_exception(void) { std::terminate(); }
+	};
+
+	LTC2983Task(LTC2983Task && other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+	LTC2983Task(const LTC2983Task &) = delete;
+	LTC2983Task & operator=(const LTC2983Task &) = delete;
+	~LTC2983Task(void) { if (_handle) _handle.destroy(); }
+
+	// top-level use: run until the first suspension, then let the event loop drive it
+	void Start(void) { if (_handle && !_handle.done()) _handle.resume(); }
+	bool Done(void) { return !_handle || _handle.done(); }
+
+	// awaited from another coroutine: start it and continue the awaiter when it ends
+	bool await_ready(void) { return Done(); }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) {
+		_handle.promise().continuation = continuation;
+		return _handle;
+	}
+	void await_resume(void) { }
+
+private:
+	explicit LTC2983Task(std::coroutine_handle<promise_type> handle) : _handle(handle) { }
+
+	std::coroutine_handle<promise_type> _handle;
+};
+
+// Coroutine front end for one chip, registered with an event loop
+class LTC2983AsyncManager {
+public:
+	LTC2983AsyncManager(LTC2983Manager * manager, LTC2983EventLoop * loop, bool use_interrupt = false);
+	~LTC2983AsyncManager(void);
+
+	LTC2983MeasureAwaiter MeasureChannel(uint8_t channel_number) { return LTC2983MeasureAwaiter(this, channel_number); }
+	LTC2983Task Sweep(LTC2983ChannelSet channels);
+
+	LTC2983Manager * Manager(void) { return _manager; }
+	bool Idle(void) { return _head == nullptr; }
+
+private:
+	friend class LTC2983MeasureAwaiter;
+	friend class LTC2983EventLoop;
+
+	void Enqueue(LTC2983MeasureAwaiter * awaiter);
+	bool Poll(void); // returns true while measurements are queued
+
+	LTC2983Manager * _manager;
+	LTC2983EventLoop * _loop;
+	bool _use_interrupt;
+	bool _converting; // _head has been started on the chip
+	uint32_t _start_us; // micros() at _head's start command
+
+	// intrusive FIFO of suspended measurements, the head is the one converting
+	LTC2983MeasureAwaiter * _head;
+	LTC2983MeasureAwaiter * _tail;
+
+	// intrusive list of chips registered with the event loop
+	LTC2983AsyncManager * _next_chip;
+};
+
+// Single-threaded completion source for any number of chips
+class LTC2983EventLoop {
+public:
+	LTC2983EventLoop(void) : _chips(nullptr) { }
+
+	bool Poll(void); // one pass over all chips, returns true while work is pending
+	void Run(void) { while (Poll()) { } }
+
+private:
+	friend class LTC2983AsyncManager;
+
+	void Register(LTC2983AsyncManager * chip);
+	void Unregister(LTC2983AsyncManager * chip);
+
+	LTC2983AsyncManager * _chips;
+};
+
+#endif // LTC2983_COROUTINES
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ *  LTC2983Decimator.cpp
+ *  Multi-rate decimation of the per-channel result stream
+ *  October 2026
+ *
+ *  See LTC2983Decimator.h for usage.
+ */
+
+#include "LTC2983Decimator.h"
+
+LTC2983Decimator::LTC2983Decimator(void) {
+	uint8_t stage;
+	for (stage = 0; stage < DECIMATOR_MAX_STAGES; stage++) {
+		_ratio[stage] = 0;
+	}
+
+	_callback = NULL;
+	_context = NULL;
+	Reset();
+}
+
+bool LTC2983Decimator::SetStage(uint8_t stage, uint16_t ratio) {
+	if (stage >= DECIMATOR_MAX_STAGES) return false;
+
+	_ratio[stage] = ratio;
+	Reset(); // partial averages from the old ratio are meaningless
+	return true;
+}
+
+void LTC2983Decimator::SetCallback(DecimatorCallback_t callback, void * context) {
+	_callback = callback;
+	_context = context;
+}
+
+void LTC2983Decimator::Push(uint8_t channel_number, int32_t fixed_temperature) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	uint8_t stage;
+	int32_t value = fixed_temperature;
+	Stage_t * state;
+
+	// each completed average becomes the input of the next stage
+	for (stage = 0; stage < DECIMATOR_MAX_STAGES && _ratio[stage] != 0; stage++) {
+		state = &_stages[channel_number][stage];
+		state->sum += value;
+		if (++state->count < _ratio[stage]) return;
+
+		value = (int32_t) (state->sum / state->count);
+		state->output = value;
+		state->ready = true;
+		state->sum = 0;
+		state->count = 0;
+
+		if (_callback != NULL) _callback(_context, channel_number, stage, float(value) / 1024);
+	}
+}
+
+bool LTC2983Decimator::OutputReady(uint8_t channel_number, uint8_t stage) {
+	if (channel_number > 20 || stage >= DECIMATOR_MAX_STAGES) return false;
+	return _stages[channel_number][stage].ready;
+}
+
+float LTC2983Decimator::Output(uint8_t channel_number, uint8_t stage) {
+	if (channel_number > 20 || stage >= DECIMATOR_MAX_STAGES) return 0.0f;
+
+	_stages[channel_number][stage].ready = false;
+	return float(_stages[channel_number][stage].output) / 1024;
+}
+
+void LTC2983Decimator::Reset(void) {
+	uint8_t channel, stage;
+	for (channel = 0; channel < 21; channel++) {
+		for (stage = 0; stage < DECIMATOR_MAX_STAGES; stage++) {
+			_stages[channel][stage].sum = 0;
+			_stages[channel][stage].count = 0;
+			_stages[channel][stage].output = 0;
+			_stages[channel][stage].ready = false;
+		}
+	}
+}
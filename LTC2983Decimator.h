@@ -0,0 +1,64 @@
+/*
+ *  LTC2983Decimator.h
+ *  Multi-rate decimation of the per-channel result stream
+ *  October 2026
+ *
+ *  One input stream per channel feeds a cascade of up to DECIMATOR_MAX_STAGES
+ *  averaging stages. Stage 0 averages every ratio[0] results, stage 1 averages every
+ *  ratio[1] outputs of stage 0, and so on, so e.g. ratios {6, 10} turn 10 s samples
+ *  into 1-minute and 10-minute averages. The boxcar average acts as the anti-aliasing
+ *  filter. All state is fixed size; sums are kept in the chip's 1/1024 degree format
+ *  so the averages are exact.
+ *
+ *  To use:
+ *    0) Instantiate an object of the class and configure stages with SetStage()
+ *    1) Attach it with LTC2983Manager::AttachDecimator(), or feed it with Push()
+ *    2) Either set a callback to receive every output as it is produced, or poll
+ *       OutputReady()/Output() for each stage
+ */
+
+#ifndef LTC2983DECIMATOR_H
+#define LTC2983DECIMATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define DECIMATOR_MAX_STAGES	3
+
+typedef void (*DecimatorCallback_t)(void * context, uint8_t channel_number, uint8_t stage, float average);
+
+class LTC2983Decimator {
+public:
+	LTC2983Decimator(void);
+	~LTC2983Decimator(void) { }; // nothing to destruct
+
+	// configuration, a ratio of 0 disables the stage and every stage after it
+	bool SetStage(uint8_t stage, uint16_t ratio);
+	void SetCallback(DecimatorCallback_t callback, void * context);
+
+	// input, temperature in 1/1024 degrees
+	void Push(uint8_t channel_number, int32_t fixed_temperature);
+
+	// output polling, reading an output clears its ready flag
+	bool OutputReady(uint8_t channel_number, uint8_t stage);
+	float Output(uint8_t channel_number, uint8_t stage);
+
+	void Reset(void);
+
+private:
+	struct Stage_t {
+		int64_t sum;
+		uint16_t count;
+		int32_t output; // last average, 1/1024 degrees
+		bool ready;
+	};
+
+	uint16_t _ratio[DECIMATOR_MAX_STAGES];
+	DecimatorCallback_t _callback;
+	void * _context;
+
+	// index corresponds to channel, 0 is unused
+	Stage_t _stages[21][DECIMATOR_MAX_STAGES];
+};
+
+#endif
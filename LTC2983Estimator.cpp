@@ -0,0 +1,90 @@
+/*
+ *  LTC2983Estimator.cpp
+ *  Per-channel scalar Kalman filter for temperature estimates between conversions
+ *  October 2026
+ *
+ *  See LTC2983Estimator.h for usage.
+ */
+
+#include "LTC2983Estimator.h"
+
+// default noise: 0.01 degrees^2 per second of drift, 0.01 degrees^2 per reading
+#define DEFAULT_PROCESS_NOISE		0.01f
+#define DEFAULT_MEASUREMENT_NOISE	0.01f
+
+LTC2983Estimator::LTC2983Estimator(void) {
+	uint8_t channel;
+	for (channel = 0; channel < 21; channel++) {
+		_channels[channel].process_noise = DEFAULT_PROCESS_NOISE;
+		_channels[channel].measurement_noise = DEFAULT_MEASUREMENT_NOISE;
+		Reset(channel);
+	}
+}
+
+void LTC2983Estimator::SetNoise(float process_noise, float measurement_noise) {
+	uint8_t channel;
+	for (channel = 1; channel < 21; channel++) {
+		SetNoise(channel, process_noise, measurement_noise);
+	}
+}
+
+void LTC2983Estimator::SetNoise(uint8_t channel_number, float process_noise, float measurement_noise) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	_channels[channel_number].process_noise = process_noise;
+	_channels[channel_number].measurement_noise = measurement_noise;
+}
+
+void LTC2983Estimator::Update(uint8_t channel_number, float temperature, uint32_t time_ms) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	ChannelState_t * state = &_channels[channel_number];
+
+	// the first reading initializes the filter directly
+	if (!state->initialized) {
+		state->estimate = temperature;
+		state->variance = state->measurement_noise;
+		state->time_ms = time_ms;
+		state->initialized = true;
+		return;
+	}
+
+	// predict to the time of the measurement, then correct
+	float prior_variance = Variance(channel_number, time_ms);
+	float gain = prior_variance / (prior_variance + state->measurement_noise);
+
+	state->estimate += gain * (temperature - state->estimate);
+	state->variance = (1.0f - gain) * prior_variance;
+	state->time_ms = time_ms;
+}
+
+// Returns the estimated temperature at time_ms, and optionally its variance. Times
+// before the last update are treated as the time of the last update.
+float LTC2983Estimator::Predict(uint8_t channel_number, uint32_t time_ms, float * variance) {
+	if (variance != NULL) *variance = Variance(channel_number, time_ms);
+	if (channel_number < 1 || channel_number > 20) return 0.0f;
+
+	return _channels[channel_number].estimate;
+}
+
+// Variance of the estimate at time_ms, grows linearly with time since the last update
+float LTC2983Estimator::Variance(uint8_t channel_number, uint32_t time_ms) {
+	if (channel_number < 1 || channel_number > 20) return -1.0f;
+
+	ChannelState_t * state = &_channels[channel_number];
+	int32_t elapsed_ms = (int32_t) (time_ms - state->time_ms);
+
+	if (!state->initialized) return -1.0f;
+	if (elapsed_ms < 0) elapsed_ms = 0;
+
+	return state->variance + state->process_noise * elapsed_ms / 1000.0f;
+}
+
+void LTC2983Estimator::Reset(uint8_t channel_number) {
+	if (channel_number > 20) return;
+
+	_channels[channel_number].initialized = false;
+	_channels[channel_number].estimate = 0.0f;
+	_channels[channel_number].variance = 0.0f;
+	_channels[channel_number].time_ms = 0;
+}
@@ -0,0 +1,58 @@
+/*
+ *  LTC2983Estimator.h
+ *  Per-channel scalar Kalman filter for temperature estimates between conversions
+ *  October 2026
+ *
+ *  Each channel is modelled as a random walk: between samples the temperature is
+ *  expected to stay where it was, while the uncertainty grows with process_noise per
+ *  second. Conversions are merged in with measurement_noise as their variance. Control
+ *  loops can then ask for an estimate (and its variance) at any time without waiting
+ *  for, or triggering, a conversion.
+ *
+ *  To use:
+ *    0) Instantiate an object of the class and set the noise levels with SetNoise()
+ *    1) Attach it with LTC2983Manager::AttachEstimator(), or feed it with Update()
+ *    2) Call Predict(channel, time_ms) whenever an estimate is needed
+ *
+ *  Note: this file does not depend on Arduino.h; times are in milliseconds from any
+ *        monotonic clock (millis() on target), and may wrap.
+ */
+
+#ifndef LTC2983ESTIMATOR_H
+#define LTC2983ESTIMATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class LTC2983Estimator {
+public:
+	LTC2983Estimator(void);
+	~LTC2983Estimator(void) { }; // nothing to destruct
+
+	// process_noise in degrees^2 per second, measurement_noise in degrees^2
+	void SetNoise(float process_noise, float measurement_noise); // all channels
+	void SetNoise(uint8_t channel_number, float process_noise, float measurement_noise);
+
+	// measurement and prediction
+	void Update(uint8_t channel_number, float temperature, uint32_t time_ms);
+	float Predict(uint8_t channel_number, uint32_t time_ms, float * variance = NULL);
+	float Variance(uint8_t channel_number, uint32_t time_ms);
+
+	bool IsInitialized(uint8_t channel_number) { return channel_number >= 1 && channel_number <= 20 && _channels[channel_number].initialized; }
+	void Reset(uint8_t channel_number);
+
+private:
+	struct ChannelState_t {
+		bool initialized;
+		float estimate;
+		float variance;
+		uint32_t time_ms; // time of the last update
+		float process_noise;
+		float measurement_noise;
+	};
+
+	// index corresponds to channel, 0 is unused
+	ChannelState_t _channels[21];
+};
+
+#endif
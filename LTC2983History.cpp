@@ -0,0 +1,108 @@
+/*
+ *  LTC2983History.cpp
+ *  Per-channel history rings with time-indexed queries
+ *  October 2026
+ *
+ *  See LTC2983History.h for usage.
+ */
+
+#include "LTC2983History.h"
+
+LTC2983History::LTC2983History(void) {
+	uint8_t channel;
+
+	for (channel = 0; channel < 21; channel++) {
+		_rings[channel].storage = NULL;
+		_rings[channel].capacity = 0;
+		Clear(channel);
+	}
+}
+
+void LTC2983History::SetStorage(uint8_t channel_number, HistorySample_t * storage, uint16_t capacity) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	_rings[channel_number].storage = storage;
+	_rings[channel_number].capacity = (storage != NULL) ? capacity : 0;
+	Clear(channel_number);
+}
+
+void LTC2983History::Clear(uint8_t channel_number) {
+	if (channel_number > 20) return;
+
+	_rings[channel_number].head = 0;
+	_rings[channel_number].count = 0;
+}
+
+// once the ring is full the oldest sample is overwritten
+bool LTC2983History::Push(uint8_t channel_number, int32_t fixed_temperature, uint32_t time_ms) {
+	if (channel_number < 1 || channel_number > 20) return false;
+
+	HistoryRing_t * ring = &_rings[channel_number];
+	if (ring->capacity == 0) return false;
+	if (ring->count > 0 && (int32_t) (time_ms - Sample(ring, ring->count - 1)->time_ms) < 0) return false;
+
+	if (ring->count == ring->capacity) {
+		ring->head = (ring->head + 1 == ring->capacity) ? 0 : ring->head + 1;
+		ring->count--;
+	}
+
+	HistorySample_t * sample = Sample(ring, ring->count);
+	sample->time_ms = time_ms;
+	sample->fixed_temperature = fixed_temperature;
+	ring->count++;
+
+	return true;
+}
+
+const HistorySample_t * LTC2983History::At(uint8_t channel_number, uint16_t index) {
+	if (channel_number > 20 || index >= _rings[channel_number].count) return NULL;
+
+	return Sample(&_rings[channel_number], index);
+}
+
+// Binary search on times measured from the oldest sample, which are increasing even
+// across a millis() rollover
+uint16_t LTC2983History::Find(uint8_t channel_number, uint32_t time_ms) {
+	if (channel_number > 20) return 0;
+
+	HistoryRing_t * ring = &_rings[channel_number];
+	if (ring->count == 0) return 0;
+
+	uint32_t oldest_ms = Sample(ring, 0)->time_ms;
+	if ((int32_t) (time_ms - oldest_ms) <= 0) return 0;
+
+	uint32_t target = time_ms - oldest_ms;
+	uint16_t low = 0;
+	uint16_t high = ring->count;
+	uint16_t middle;
+
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (Sample(ring, middle)->time_ms - oldest_ms < target) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+uint16_t LTC2983History::ForEach(uint8_t channel_number, uint32_t from_ms, uint32_t to_ms, HistoryVisitor_t visitor, void * context) {
+	uint16_t visited = 0;
+	uint16_t index;
+	const HistorySample_t * sample;
+
+	if (channel_number > 20 || visitor == NULL) return 0;
+
+	HistoryRing_t * ring = &_rings[channel_number];
+	for (index = Find(channel_number, from_ms); index < ring->count; index++) {
+		sample = Sample(ring, index);
+		if ((int32_t) (sample->time_ms - to_ms) > 0) break;
+
+		visited++;
+		if (!visitor(context, channel_number, sample)) break;
+	}
+
+	return visited;
+}
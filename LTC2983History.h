@@ -0,0 +1,76 @@
+/*
+ *  LTC2983History.h
+ *  Per-channel history rings with time-indexed queries
+ *  October 2026
+ *
+ *  Keeps the most recent results of each channel in a ring of fixed-point samples over
+ *  storage the caller provides, so memory use is fixed at compile time and channels
+ *  can be given different depths. Timestamps within a channel never go backwards, so
+ *  the ring is sorted by time: finding a time is a binary search, and a time range is
+ *  visited in place through a callback without copying the buffer.
+ *
+ *  To use:
+ *    0) Instantiate an object of the class and give each channel of interest its
+ *       storage with SetStorage()
+ *    1) Attach it with LTC2983Manager::AttachHistory(), or feed it with Push()
+ *    2) Query with Find()/At() or ForEach(), e.g. the last 10 minutes of channel 7:
+ *         history.ForEach(7, millis() - 600000, millis(), visitor, context);
+ *
+ *  For coarser, older data, a second history can be fed from a LTC2983Decimator
+ *  callback with the decimated averages.
+ *
+ *  Note: times are millis() and compared modulo 2^32, so one channel's ring must span
+ *        less than ~24 days.
+ */
+
+#ifndef LTC2983HISTORY_H
+#define LTC2983HISTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct HistorySample_t {
+	uint32_t time_ms;
+	int32_t fixed_temperature; // 1/1024 degrees
+};
+
+// return false to stop the iteration
+typedef bool (*HistoryVisitor_t)(void * context, uint8_t channel_number, const HistorySample_t * sample);
+
+class LTC2983History {
+public:
+	LTC2983History(void);
+	~LTC2983History(void) { }; // nothing to destruct
+
+	// storage, capacity samples per channel (NULL or 0 to stop recording a channel)
+	void SetStorage(uint8_t channel_number, HistorySample_t * storage, uint16_t capacity);
+	void Clear(uint8_t channel_number);
+
+	// input, false if the channel has no storage or time_ms is older than its newest sample
+	bool Push(uint8_t channel_number, int32_t fixed_temperature, uint32_t time_ms);
+
+	// indexed access, index 0 is the oldest sample
+	uint16_t Count(uint8_t channel_number) { return (channel_number <= 20) ? _rings[channel_number].count : 0; }
+	const HistorySample_t * At(uint8_t channel_number, uint16_t index); // NULL if out of range
+	uint16_t Find(uint8_t channel_number, uint32_t time_ms); // first index at or after time_ms, Count() if none
+
+	// visits the samples from from_ms to to_ms (inclusive) oldest first, returns the number visited
+	uint16_t ForEach(uint8_t channel_number, uint32_t from_ms, uint32_t to_ms, HistoryVisitor_t visitor, void * context);
+
+private:
+	struct HistoryRing_t {
+		HistorySample_t * storage;
+		uint16_t capacity;
+		uint16_t head; // oldest sample
+		uint16_t count;
+	};
+
+	HistorySample_t * Sample(HistoryRing_t * ring, uint16_t index) {
+		uint32_t position = (uint32_t) ring->head + index;
+		return &ring->storage[position >= ring->capacity ? position - ring->capacity : position];
+	}
+
+	HistoryRing_t _rings[21]; // index corresponds to channel, 0 is unused
+};
+
+#endif
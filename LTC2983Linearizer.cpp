@@ -0,0 +1,195 @@
+/*
+ *  LTC2983Linearizer.cpp
+ *  Lookup-table linearization of raw sensor resistance into temperature
+ *  October 2026
+ *
+ *  See LTC2983Linearizer.h for usage.
+ */
+
+#include "LTC2983Linearizer.h"
+#include <math.h>
+
+#define KELVIN_OFFSET	273.15f
+#define CVD_ITERATIONS	8
+
+LTC2983Linearizer::LTC2983Linearizer(void) {
+	_model = MODEL_RTD;
+	_axis = LINEARIZER_AXIS_LINEAR;
+	_u_min = 0.0f;
+	_inv_step = 0.0f;
+	_max_position = 0.0f;
+	_built = false;
+
+	uint8_t i;
+	for (i = 0; i < 4; i++) {
+		_p[i] = 0.0f;
+	}
+}
+
+// Table generation -----------------------------------------------------------
+bool LTC2983Linearizer::BuildRTD(float r0, float a, float b, float c, float r_min, float r_max) {
+	if (r0 <= 0.0f || a <= 0.0f) return false;
+
+	_model = MODEL_RTD;
+	_p[0] = r0;
+	_p[1] = a;
+	_p[2] = b;
+	_p[3] = c;
+
+	return Fill(LINEARIZER_AXIS_LINEAR, r_min, r_max);
+}
+
+bool LTC2983Linearizer::BuildBetaThermistor(float r25, float beta, float r_min, float r_max) {
+	if (r25 <= 0.0f || beta <= 0.0f) return false;
+
+	_model = MODEL_BETA;
+	_p[0] = r25;
+	_p[1] = beta;
+	_p[2] = 0.0f;
+	_p[3] = 0.0f;
+
+	return Fill(LINEARIZER_AXIS_LOG2, r_min, r_max);
+}
+
+bool LTC2983Linearizer::BuildSteinhartHart(float a, float b, float c, float r_min, float r_max) {
+	_model = MODEL_STEINHART_HART;
+	_p[0] = a;
+	_p[1] = b;
+	_p[2] = c;
+	_p[3] = 0.0f;
+
+	return Fill(LINEARIZER_AXIS_LOG2, r_min, r_max);
+}
+
+// Evaluation -----------------------------------------------------------------
+float LTC2983Linearizer::Evaluate(float resistance) {
+	float u = (_axis == LINEARIZER_AXIS_LOG2) ? Log2Approx(resistance) : resistance;
+
+	// clamp without branching (fminf/fmaxf map to single min/max instructions)
+	float position = fminf(fmaxf((u - _u_min) * _inv_step, 0.0f), _max_position);
+	uint32_t index = (uint32_t) position;
+	float fraction = position - (float) index;
+
+	return _celsius[index] + fraction * (_celsius[index + 1] - _celsius[index]);
+}
+
+void LTC2983Linearizer::Evaluate(const float * resistances, float * temperatures, uint32_t count) {
+	uint32_t i, index;
+	float position, fraction;
+
+	// the axis choice is hoisted out of the loop so each loop body is straight-line code
+	if (_axis == LINEARIZER_AXIS_LOG2) {
+		for (i = 0; i < count; i++) {
+			position = fminf(fmaxf((Log2Approx(resistances[i]) - _u_min) * _inv_step, 0.0f), _max_position);
+			index = (uint32_t) position;
+			fraction = position - (float) index;
+			temperatures[i] = _celsius[index] + fraction * (_celsius[index + 1] - _celsius[index]);
+		}
+	} else {
+		for (i = 0; i < count; i++) {
+			position = fminf(fmaxf((resistances[i] - _u_min) * _inv_step, 0.0f), _max_position);
+			index = (uint32_t) position;
+			fraction = position - (float) index;
+			temperatures[i] = _celsius[index] + fraction * (_celsius[index + 1] - _celsius[index]);
+		}
+	}
+}
+
+// Private methods ------------------------------------------------------------
+bool LTC2983Linearizer::Fill(Linearizer_Axis_t axis, float r_min, float r_max) {
+	_built = false;
+	if (r_min <= 0.0f || r_max <= r_min || r_max > LINEARIZER_MAX_RESISTANCE) return false;
+
+	_axis = axis;
+	float u_min, step;
+	uint32_t intervals, per_octave = 0;
+
+	if (axis == LINEARIZER_AXIS_LOG2) {
+		// Log2Approx() changes slope at every power of two, so the range is widened to
+		// whole octaves with a whole number of intervals in each, making every power
+		// of two a table node; interpolation then never straddles a slope break
+		u_min = floorf(Log2Approx(r_min));
+		uint32_t octaves = (uint32_t) (ceilf(Log2Approx(r_max)) - u_min);
+		if (octaves == 0) octaves = 1;
+		per_octave = LINEARIZER_TABLE_SIZE / octaves;
+		if (per_octave == 0) return false;
+
+		intervals = per_octave * octaves;
+		step = 1.0f / per_octave;
+	} else {
+		u_min = r_min;
+		intervals = LINEARIZER_TABLE_SIZE;
+		step = (r_max - r_min) / LINEARIZER_TABLE_SIZE;
+	}
+
+	uint32_t i;
+	float resistance, kelvin, scaled;
+	for (i = 0; i <= intervals; i++) {
+		if (axis == LINEARIZER_AXIS_LOG2) {
+			// octave and fraction kept apart so the nodes land exactly on 2^k
+			resistance = ldexpf(1.0f + (i % per_octave) * step, (int) u_min + (int) (i / per_octave));
+		} else {
+			resistance = u_min + step * i;
+		}
+		kelvin = ModelKelvin(resistance);
+
+		// octave widening can put the last node on 2^22 itself, which would overflow
+		scaled = resistance * 1024.0f + 0.5f;
+		table[i].measurement = (scaled < 4294967296.0f) ? (uint32_t) scaled : 0xFFFFFFFF;
+		table[i].temperature = (kelvin > 0.0f) ? (uint32_t) (kelvin * 1024.0f + 0.5f) : 0;
+		_celsius[i] = kelvin - KELVIN_OFFSET;
+	}
+
+	// entries past the last interval repeat it
+	for (i = intervals + 1; i <= LINEARIZER_TABLE_SIZE + 1; i++) {
+		if (i <= LINEARIZER_TABLE_SIZE) table[i] = table[intervals];
+		_celsius[i] = _celsius[intervals];
+	}
+
+	_u_min = u_min;
+	_inv_step = 1.0f / step;
+	_max_position = (float) intervals;
+	_built = true;
+
+	return true;
+}
+
+float LTC2983Linearizer::ModelKelvin(float resistance) {
+	double t, r_t, slope, ln_r;
+	uint8_t i;
+
+	switch (_model) {
+	case MODEL_RTD:
+		// invert R(T) = R0 (1 + A T + B T^2 + C (T - 100) T^3) with Newton's method,
+		// the C term only applies below 0 C
+		t = (resistance / _p[0] - 1.0) / _p[1];
+		for (i = 0; i < CVD_ITERATIONS; i++) {
+			if (t < 0.0) {
+				r_t = _p[0] * (1.0 + _p[1] * t + _p[2] * t * t + _p[3] * (t - 100.0) * t * t * t);
+				slope = _p[0] * (_p[1] + 2.0 * _p[2] * t + _p[3] * (4.0 * t * t * t - 300.0 * t * t));
+			} else {
+				r_t = _p[0] * (1.0 + _p[1] * t + _p[2] * t * t);
+				slope = _p[0] * (_p[1] + 2.0 * _p[2] * t);
+			}
+			t -= (r_t - resistance) / slope;
+		}
+		return (float) t + KELVIN_OFFSET;
+	case MODEL_BETA:
+		// 1/T = 1/T25 + ln(R / R25) / beta
+		return (float) (1.0 / (1.0 / (25.0 + KELVIN_OFFSET) + log(resistance / _p[0]) / _p[1]));
+	case MODEL_STEINHART_HART:
+		// 1/T = a + b ln(R) + c ln(R)^3
+		ln_r = log(resistance);
+		return (float) (1.0 / (_p[0] + _p[1] * ln_r + _p[2] * ln_r * ln_r * ln_r));
+	default:
+		return 0.0f;
+	}
+}
+
+// Piecewise-linear log2: with R = m * 2^e and m in [0.5, 1), returns e + 2m - 2. This
+// is exact at powers of two, continuous and strictly increasing in between.
+float LTC2983Linearizer::Log2Approx(float resistance) {
+	int exponent;
+	float mantissa = frexpf(resistance, &exponent);
+	return (float) exponent + 2.0f * mantissa - 2.0f;
+}
@@ -0,0 +1,101 @@
+/*
+ *  LTC2983Linearizer.h
+ *  Lookup-table linearization of raw sensor resistance into temperature
+ *  October 2026
+ *
+ *  The LTC2983 reports the raw sensor resistance of RTD and thermistor channels in its
+ *  VOUT region (see LTC2983Manager::ReadChannelResistance). This class converts those
+ *  resistances into temperatures on the host, using a sensor model that is evaluated
+ *  once into a dense table and then linearly interpolated, so that reprocessing large
+ *  archives never calls log() or pow() per sample.
+ *
+ *  To use:
+ *    0) Instantiate an object of the class (one per sensor model)
+ *    1) Build the table with BuildRTD(), BuildBetaThermistor() or BuildSteinhartHart()
+ *       over the resistance range of interest
+ *    2) Convert single readings with Evaluate(float) or arrays with Evaluate(in, out, n)
+ *
+ *  Table entries use struct table_coeffs, with both fields scaled by 1024 like the
+ *  chip's own results: measurement is the resistance in ohms, temperature is in kelvin.
+ *  RTD tables are spaced linearly in resistance; thermistor tables are spaced evenly in
+ *  a piecewise-linear approximation of log2(R), which follows the exponential R(T)
+ *  curve closely while still being computable with frexpf() alone. Thermistor ranges
+ *  are widened to whole octaves so that every power of two, where that approximation
+ *  changes slope, is a table node.
+ *
+ *  Note: this file does not depend on Arduino.h so that it can be built on the ground.
+ */
+
+#ifndef LTC2983LINEARIZER_H
+#define LTC2983LINEARIZER_H
+
+#include "LTC2983_table_coeffs.h"
+#include <stdint.h>
+
+#ifndef LINEARIZER_TABLE_SIZE
+#define LINEARIZER_TABLE_SIZE	512 // number of intervals, the table holds one extra entry
+#endif
+
+// largest r_max accepted, 2^22 ohms: times 1024 it just fills the 32-bit measurement field
+// (the 2^22 node itself is stored one LSB low)
+#define LINEARIZER_MAX_RESISTANCE	4194304.0f
+
+// Callendar-Van Dusen coefficients for IEC 60751 (European, alpha = 0.00385) platinum
+#define CVD_A_EUROPEAN	3.9083e-3f
+#define CVD_B_EUROPEAN	-5.775e-7f
+#define CVD_C_EUROPEAN	-4.183e-12f
+
+enum Linearizer_Axis_t {
+	LINEARIZER_AXIS_LINEAR,	// entries evenly spaced in resistance
+	LINEARIZER_AXIS_LOG2	// entries evenly spaced in approximate log2(resistance)
+};
+
+class LTC2983Linearizer {
+public:
+	LTC2983Linearizer(void);
+	~LTC2983Linearizer(void) { }; // nothing to destruct
+
+	// table generation, resistances in ohms, returns false on an invalid range (including
+	// r_max above LINEARIZER_MAX_RESISTANCE)
+	bool BuildRTD(float r0, float a, float b, float c, float r_min, float r_max);
+	bool BuildBetaThermistor(float r25, float beta, float r_min, float r_max);
+	bool BuildSteinhartHart(float a, float b, float c, float r_min, float r_max);
+
+	// evaluation, returns degrees C (clamped to the table ends outside the range)
+	float Evaluate(float resistance);
+	void Evaluate(const float * resistances, float * temperatures, uint32_t count);
+
+	bool IsBuilt(void) { return _built; }
+
+	// table entries, LINEARIZER_TABLE_SIZE + 1 of them once built
+	struct table_coeffs table[LINEARIZER_TABLE_SIZE + 1];
+
+private:
+	enum Model_t {
+		MODEL_RTD,
+		MODEL_BETA,
+		MODEL_STEINHART_HART
+	};
+
+	bool Fill(Linearizer_Axis_t axis, float r_min, float r_max);
+	float ModelKelvin(float resistance);
+
+	static float Log2Approx(float resistance);
+
+	// model parameters
+	Model_t _model;
+	float _p[4];
+
+	// axis and interpolation state
+	Linearizer_Axis_t _axis;
+	float _u_min;
+	float _inv_step;
+	float _max_position;
+	bool _built;
+
+	// table temperatures converted to degrees C once, so evaluation is float-only; the
+	// last entry repeats the one before it so the top of the range needs no bounds check
+	float _celsius[LINEARIZER_TABLE_SIZE + 2];
+};
+
+#endif
@@ -31,22 +31,79 @@
  */
 
 #include "LTC2983Manager.h"
+#include <math.h>
 
 LTC2983Manager::LTC2983Manager(int cs_pin, int rst_pin, uint8_t therm_sense_ch, uint8_t rtd_sense_ch) {
 	_chip_select_pin = cs_pin;
 	_reset_pin = rst_pin;
 	_sleeping = false;
 	_measurement_finished = false;
+	_wait_mode = WAIT_POLL;
+	_idle_handler = NULL;
+	_idle_context = NULL;
+	_idle_time_us = 0;
     _spi = 0;
     setSpiSup(_spi);
+	_global_config = TEMP_UNIT__C | REJECTION__50_60_HZ;
+	_mux_delay = 0; // conversion delay = 0 us
+	_words_loaded = false;
+	_active_profile = -1;
+	_conversion_time_us[0] = NOMINAL_CONVERSION_TIME_US;
+	_conversion_time_us[1] = NOMINAL_CONVERSION_TIME_US;
+	_conversion_time_us[2] = NOMINAL_CONVERSION_TIME_US;
+	_conversion_time_us[3] = NOMINAL_CONVERSION_TIME_US;
+	_conversion_time_pinned = 0;
+	_config_crc = 0;
+	_integrity_check_interval = 0;
+	_sweeps_since_check = 0;
+	_configuration_repairs = 0;
+	_alarm_flags = LTC2983ChannelSet::None();
+	_alarm_callback = NULL;
+	_adaptive_enabled = false;
+	_adaptive_min_period_ms = 0;
+	_adaptive_max_period_ms = 0;
+	_adaptive_rate_threshold = 0;
+	_sweep_channels = LTC2983ChannelSet::None();
+	_lazy_pending = LTC2983ChannelSet::None();
+	_lazy_valid = LTC2983ChannelSet::None();
+	_lazy_completed_ms = 0;
+	_lazy_completed_us = 0;
+	_finished_ms = 0;
+	_finished_us = 0;
+	_in_flight = -1;
+	_has_result = LTC2983ChannelSet::None();
+	_excitation_calibrating = false;
+	_excitation_fallbacks = LTC2983ChannelSet::None();
+	_estimator = NULL;
+	_decimator = NULL;
+	_history = NULL;
+	_quantile_sketch = NULL;
 
 	// initialize all channels to unused, and all temperature results to error values
 	uint8_t channel;
 	for (channel = 0; channel < 21; channel++) {
 		channel_assignments[channel] = UNUSED_CHANNEL;
 		channel_temperatures[channel] = TEMPERATURE_ERROR;
+		_channel_words[channel] = 0;
+		_alarms[channel].enabled = false;
+		_alarms[channel].priority = false;
+		_alarms[channel].state = ALARM_NONE;
+		_adaptive[channel].primed = false;
+		_adaptive[channel].period_ms = 0;
+		_therm_excitation[channel] = EXCITATION_CODE_AUTORANGE;
 	}
 
+	uint8_t profile;
+	for (profile = 0; profile < LTC2983_MAX_PROFILES; profile++) {
+		_profiles[profile].defined = false;
+	}
+
+	uint8_t subscription;
+	for (subscription = 0; subscription < LTC2983_MAX_SUBSCRIBERS; subscription++) {
+		_subscriptions[subscription].channels = LTC2983ChannelSet::None();
+	}
+	_subscribed_events = 0;
+
 	// if there's a thermistor sense resistor, assign it
 	if (therm_sense_ch > 0 && therm_sense_ch < 21) {
 		_therm_sense_channel = therm_sense_ch;
@@ -109,36 +166,182 @@ uint8_t LTC2983Manager::CheckStatusReg(void) {
 }
 
 uint32_t LTC2983Manager::ReadFullChannelData(uint8_t channel_number) {
-	convert_channel(_chip_select_pin, channel_number);
+	StartMeasurement(channel_number);
+	WaitForConversion();
+	_measurement_finished = false;
+	_in_flight = -1;
 	uint16_t start_address = get_start_address(CONVERSION_RESULT_MEMORY_BASE,channel_number);
 	return transfer_four_bytes(_chip_select_pin,READ_FROM_RAM,start_address,0);
 }
 
 void LTC2983Manager::MeasureAllChannels(void) {
-	uint8_t channel;
+	if (_adaptive_enabled) {
+		MeasureChannels(DueChannels(millis()));
+	} else {
+		MeasureChannels(LTC2983ChannelSet::All());
+	}
+}
 
-	for (channel = 1; channel < 21; channel++) {
+void LTC2983Manager::MeasureChannels(LTC2983ChannelSet channels) {
+	uint8_t since_priority = 0;
+
+	for (uint8_t channel : channels) {
 		MeasureChannel(channel);
+
+		if (!_alarm_flags.Empty() && ++since_priority >= ALARM_PRIORITY_INTERLEAVE) {
+			since_priority = 0;
+			MeasurePriorityAlarms();
+		}
 	}
+
+	EndOfSweep();
+}
+
+// Same results as MeasureChannels(), but the ADC is kept busy: as soon as a conversion
+// finishes its result is read and the next channel's conversion is started in the
+// same SPI transaction, and the result is decoded and dispatched while that next
+// conversion runs. Priority alarm channels are not interleaved in this mode.
+void LTC2983Manager::MeasureChannelsPipelined(LTC2983ChannelSet channels) {
+	uint8_t previous = 0; // channel currently converting, 0 if none
+	uint32_t raw_result;
+
+	if (_sleeping) WakeUp();
+
+	for (uint8_t channel : channels) {
+		if (!IsMeasurable(channel)) {
+			channel_temperatures[channel] = TEMPERATURE_ERROR;
+			continue;
+		}
+
+		if (previous == 0) {
+			StartMeasurement(channel);
+		} else {
+			WaitForConversion();
+			_measurement_finished = false;
+			raw_result = get_raw_result_and_convert(_chip_select_pin, previous, channel);
+			HandleResult(previous, raw_result);
+		}
+		previous = channel;
+	}
+
+	if (previous != 0) {
+		WaitForConversion();
+		HandleResult(previous, get_raw_result(_chip_select_pin, previous));
+		_in_flight = -1;
+	}
+
+	EndOfSweep();
 }
 
 float LTC2983Manager::MeasureChannel(uint8_t channel_number) {
 	if (_sleeping) WakeUp();
-	Sensor_Type_t assignment = channel_assignments[channel_number];
 	float temp = TEMPERATURE_ERROR;
 
-	if (assignment == THERMISTOR_44006 || assignment == RTD_PT_100) {
-		temp =  measure_channel(_chip_select_pin, channel_number, TEMPERATURE);
+	if (IsMeasurable(channel_number)) {
+		uint32_t start_us = micros();
+		StartMeasurement(channel_number);
+		WaitForConversion();
+		_measurement_finished = false;
+		_in_flight = -1;
+		LearnConversionTime(micros() - start_us, 1);
+		temp = HandleResult(channel_number, get_raw_result(_chip_select_pin, channel_number));
+
+		return temp;
 	}
 
 	channel_temperatures[channel_number] = temp;
 	return temp;
 }
 
+// Returns the sensor resistance in ohms from the last conversion of an RTD or thermistor
+// channel (the VOUT region), for linearization on the ground with LTC2983Linearizer
+float LTC2983Manager::ReadChannelResistance(uint8_t channel_number) {
+	if (!IsMeasurable(channel_number)) return TEMPERATURE_ERROR;
+
+	return get_voltage_or_resistance_result(_chip_select_pin, channel_number);
+}
+
+// cached reads ---------------------------------------------------------------
+// Returns the stored result if it is at most max_age_ms old. Otherwise, if a
+// non-blocking conversion of this channel is already running, waits for and shares
+// it; if not, converts the channel. Any other conversion or sweep still outstanding is
+// finished and its results decoded first, so they are not lost to the new start.
+float LTC2983Manager::GetChannel(uint8_t channel_number, uint32_t max_age_ms) {
+	if (ResultAge(channel_number) <= max_age_ms) return channel_temperatures[channel_number];
+
+	if (_in_flight == channel_number) {
+		WaitForConversion();
+		return ReadMeasurementResult(channel_number);
+	}
+
+	if (_in_flight == 0) {
+		WaitForConversion();
+		while (!ReadSweepResults()) {
+			delay(SWEEP_POLL_INTERVAL_MS);
+		}
+
+		// the sweep may have converted this channel too
+		if (ResultAge(channel_number) <= max_age_ms) return channel_temperatures[channel_number];
+	} else if (_in_flight > 0) {
+		WaitForConversion();
+		ReadMeasurementResult((uint8_t) _in_flight);
+	}
+
+	return MeasureChannel(channel_number);
+}
+
+// Non-blocking form of GetChannel() for several tasks polling the same channel: returns
+// true with *result once a fresh enough value exists. The first caller that finds the
+// chip idle starts the conversion, and every caller then shares it. Returns false while
+// the conversion (or another channel's) is still running.
+bool LTC2983Manager::RequestChannel(uint8_t channel_number, uint32_t max_age_ms, float * result) {
+	if (ResultAge(channel_number) <= max_age_ms) {
+		*result = channel_temperatures[channel_number];
+		return true;
+	}
+
+	if (!IsMeasurable(channel_number)) {
+		*result = TEMPERATURE_ERROR;
+		return true;
+	}
+
+	if (_in_flight == channel_number) {
+		if (!FinishedMeasurement()) return false;
+		*result = ReadMeasurementResult(channel_number);
+		return true;
+	}
+
+	// another channel's conversion or a sweep is consumed once done, even if whoever
+	// started it never asks again, so it cannot hold the chip forever
+	if (_in_flight > 0) {
+		if (!FinishedMeasurement()) return false;
+		ReadMeasurementResult((uint8_t) _in_flight);
+	} else if (_in_flight == 0) {
+		if (!ReadSweepResults()) return false;
+	}
+
+	if (_sleeping) WakeUp();
+	StartMeasurement(channel_number);
+	return false;
+}
+
+uint32_t LTC2983Manager::ResultAge(uint8_t channel_number) {
+	if (!_has_result.Contains(channel_number)) return 0xFFFFFFFF;
+
+	return millis() - _result_time_ms[channel_number];
+}
+
 // non-blocking methods -------------------------------------------------------
+// Pending excitation fallbacks are applied here, the last point where the chip is known
+// to be idle, so every front end gets them. Sweeps apply them in PrepareSweep() instead,
+// keeping the start of a prepared sweep down to the command byte.
 void LTC2983Manager::StartMeasurement(uint8_t channel_number)
 {
+	if (channel_number != 0 && !_excitation_fallbacks.Empty()) ApplyExcitationFallbacks();
+
 	_measurement_finished = false;
+	_lazy_pending = LTC2983ChannelSet::None(); // results in chip RAM are about to change
+	_in_flight = channel_number;
 	transfer_byte(_chip_select_pin, WRITE_TO_RAM, COMMAND_STATUS_REGISTER, CONVERSION_CONTROL_BYTE | channel_number);
 }
 
@@ -153,21 +356,709 @@ bool LTC2983Manager::FinishedMeasurement(void)
 	return (status_byte & 0x40);
 }
 
+// for front ends that gave up waiting: once the chip is done, its RAM no longer counts as
+// a pending result and a late interrupt no longer reads as the next one's completion
+void LTC2983Manager::DiscardConversion(void) {
+	_measurement_finished = false;
+	_sweep_channels = LTC2983ChannelSet::None();
+	_in_flight = -1;
+}
+
 float LTC2983Manager::ReadMeasurementResult(uint8_t channel_number)
 {
+	uint32_t completed_ms, completed_us;
+
+	CompletionTime(&completed_ms, &completed_us);
 	_measurement_finished = false; // reset the flag
 
 	// verify that the device is ready to read
 	if (!FinishedMeasurement()) return TEMPERATURE_ERROR;
 
-	return get_result(_chip_select_pin, channel_number, TEMPERATURE);
+	_in_flight = -1;
+	return HandleResult(channel_number, get_raw_result(_chip_select_pin, channel_number), completed_ms, completed_us);
 }
 
+// the completion time is recorded here, so results read later keep it
 void LTC2983Manager::InterruptHandler(void)
 {
+	_finished_ms = millis();
+	_finished_us = micros();
 	_measurement_finished = true;
 }
 
+// A host build can pass a handler that advances a modelled clock, calls
+// InterruptHandler() once the modelled conversion is done and returns the elapsed time
+void LTC2983Manager::SetIdleHandler(IdleHandler_t handler, void * context) {
+	_idle_handler = handler;
+	_idle_context = context;
+}
+
+// multi-channel conversions ---------------------------------------------------
+// Starts one conversion of every measurable channel in channels using the chip's
+// multiple channel mask register; completion is signalled like a single conversion
+void LTC2983Manager::StartSweep(LTC2983ChannelSet channels) {
+	PrepareSweep(channels);
+	if (_sweep_channels.Empty()) return; // nothing measurable, there is nothing to start
+
+	StartMeasurement(0);
+}
+
+// Writes the sweep's channels to the mask register ahead of time, so that starting it
+// later is a single command byte (see LTC2983SyncGroup)
+void LTC2983Manager::PrepareSweep(LTC2983ChannelSet channels) {
+	if (_sleeping) WakeUp();
+	if (!_excitation_fallbacks.Empty()) ApplyExcitationFallbacks();
+
+	_sweep_channels = channels & MeasurableChannels();
+	transfer_four_bytes(_chip_select_pin, WRITE_TO_RAM, MULTIPLE_CHANNEL_MASK_REGISTER, _sweep_channels.ToChipMask());
+}
+
+// Result RAM is not touched while the chip converts: until the interrupt flag or the
+// status register shows the sweep done, only the status byte is read. Then the status
+// and the result words are read in a single burst from 0x000 to the last channel in
+// the sweep, and every result is decoded through the normal result path.
+bool LTC2983Manager::ReadSweepResults(void) {
+	uint8_t buffer[CONVERSION_RESULT_MEMORY_BASE + 80]; // status through channel 20's result
+	uint8_t * word;
+
+	if (_sweep_channels.Empty()) return true;
+	if (!_measurement_finished && !FinishedMeasurement()) return false;
+
+	transfer_ram_block(_chip_select_pin, READ_FROM_RAM, COMMAND_STATUS_REGISTER, buffer, get_start_address(CONVERSION_RESULT_MEMORY_BASE, _sweep_channels.Last()) + 4);
+
+	// if bit 6 is set, the conversion is finished
+	if (!(buffer[COMMAND_STATUS_REGISTER] & 0x40)) return false;
+
+	// every result of the sweep is stamped with the time it was seen to be done
+	uint32_t completed_ms, completed_us;
+	CompletionTime(&completed_ms, &completed_us);
+
+	_measurement_finished = false;
+	for (uint8_t channel : _sweep_channels) {
+		word = &buffer[get_start_address(CONVERSION_RESULT_MEMORY_BASE, channel)];
+		HandleResult(channel, (uint32_t) word[0] << 24 | (uint32_t) word[1] << 16 | (uint32_t) word[2] << 8 | (uint32_t) word[3], completed_ms, completed_us);
+	}
+
+	_sweep_channels = LTC2983ChannelSet::None();
+	_in_flight = -1;
+	return true;
+}
+
+// Nothing is polled before the sweep can be done: in WAIT_LOW_POWER the MCU idles, and
+// otherwise it waits until one poll interval before EstimateSweepDuration() and then
+// polls the status byte. The results then come in one burst.
+//
+// The sweep finished between the last poll that saw it converting and the one that saw
+// it done, so half a poll interval is taken off the learned time; if the first poll
+// already saw it done, the learned time still drops by that much each sweep until the
+// wait ends before completion again. In WAIT_LOW_POWER the interrupt time is exact.
+void LTC2983Manager::MeasureSweep(LTC2983ChannelSet channels) {
+	uint32_t start_us = micros();
+	uint32_t busy_us = start_us; // last time the sweep was known to be converting
+	uint32_t done_us;
+	uint32_t slack_us;
+	uint32_t wait_ms;
+
+	StartSweep(channels);
+	uint8_t conversions = _sweep_channels.Count();
+	if (conversions == 0) return;
+
+	if (_wait_mode == WAIT_LOW_POWER) {
+		WaitForConversion();
+		done_us = _finished_us;
+		busy_us = done_us;
+	} else {
+		wait_ms = EstimateSweepDuration(_sweep_channels) / 1000;
+		delay(wait_ms > SWEEP_POLL_INTERVAL_MS ? wait_ms - SWEEP_POLL_INTERVAL_MS : 0);
+
+		while (!FinishedMeasurement()) {
+			busy_us = micros();
+			delay(SWEEP_POLL_INTERVAL_MS);
+		}
+		done_us = micros();
+	}
+
+	ReadSweepResults();
+
+	slack_us = done_us - busy_us;
+	if (slack_us > (uint32_t) SWEEP_POLL_INTERVAL_MS * 1000) slack_us = (uint32_t) SWEEP_POLL_INTERVAL_MS * 1000;
+	LearnConversionTime(done_us - start_us - slack_us / 2, conversions);
+
+	EndOfSweep();
+}
+
+// Front ends that wait for a sweep themselves (LTC2983RtosManager, LTC2983SyncGroup)
+// call this once its results are read, so the sweep gets the same end-of-sweep work as
+// MeasureSweep(). elapsed_us is from the start command to completion; pass 0 if it is
+// not known precisely enough to learn the conversion time from.
+void LTC2983Manager::FinishSweep(uint32_t elapsed_us, uint8_t conversions) {
+	if (elapsed_us > 0) LearnConversionTime(elapsed_us, conversions);
+
+	EndOfSweep();
+}
+
+// global configuration ------------------------------------------------------
+// Sets the 50/60 Hz rejection mode and temperature unit. Results (and alarm limits)
+// are in the selected unit. The setting is stored in the active profile and the
+// configuration image like the MUX delay.
+void LTC2983Manager::SetGlobalConfiguration(uint8_t rejection, uint8_t temp_unit) {
+	if (_sleeping) WakeUp();
+
+	_global_config = (rejection & 0x3) | (temp_unit & TEMP_UNIT__F);
+	transfer_byte(_chip_select_pin, WRITE_TO_RAM, GLOBAL_CONFIGURATION_REGISTER, _global_config);
+	UpdateConfigCrc();
+
+	if (_active_profile >= 0) _profiles[_active_profile].global_config = _global_config;
+}
+
+// Replaces the conversion time for a rejection mode. With pin set (the default) the
+// value is kept as given, otherwise it keeps being refined by measurement.
+void LTC2983Manager::SetConversionTime(uint8_t rejection, uint32_t time_us, bool pin) {
+	_conversion_time_us[rejection & 0x3] = time_us;
+
+	if (pin) {
+		_conversion_time_pinned |= 1 << (rejection & 0x3);
+	} else {
+		_conversion_time_pinned &= ~(1 << (rejection & 0x3));
+	}
+}
+
+// Time to convert the measurable channels in channels one after another with the
+// current rejection mode and MUX delay
+uint32_t LTC2983Manager::EstimateSweepDuration(LTC2983ChannelSet channels) {
+	uint32_t per_channel_us = _conversion_time_us[_global_config & 0x3] + (uint32_t) _mux_delay * 100;
+
+	return per_channel_us * (channels & MeasurableChannels()).Count();
+}
+
+// MUX settling delay ----------------------------------------------------------
+// The delay is stored in the active profile too, so switching away and back keeps it,
+// and it is part of the configuration image
+void LTC2983Manager::SetMuxDelay(uint8_t delay) {
+	if (_sleeping) WakeUp();
+
+	_mux_delay = delay;
+	transfer_byte(_chip_select_pin, WRITE_TO_RAM, MUX_CONFIGURATION_REGISTER, _mux_delay);
+	UpdateConfigCrc();
+
+	if (_active_profile >= 0) _profiles[_active_profile].mux_delay = delay;
+}
+
+// Finds the smallest MUX delay at which every channel in channels (at least two, so
+// the MUX switches before each conversion) reads with a standard deviation of at most
+// max_std_dev degrees over samples sweeps. Delays are tried in doubling steps, then the
+// last interval is bisected. The result is applied with SetMuxDelay() and returned;
+// if no delay is stable the maximum (25.5 ms) is used. With fewer than two measurable
+// channels nothing is tuned and the current delay is returned.
+uint8_t LTC2983Manager::TuneMuxDelay(LTC2983ChannelSet channels, uint8_t samples, float max_std_dev) {
+	int64_t max_variance = (int64_t) (max_std_dev * 1024) * (int64_t) (max_std_dev * 1024);
+	uint16_t unstable = 0; // largest delay known to be unstable, 0 if none yet
+	uint16_t stable = 0;
+	uint16_t delay;
+
+	channels &= MeasurableChannels();
+	if (channels.Count() < 2) return _mux_delay;
+	if (samples < 2) samples = 2;
+
+	for (delay = 0; delay <= 255; delay = (delay == 0) ? 1 : delay * 2) {
+		SetMuxDelay(delay);
+		if (MuxDelayIsStable(channels, samples, max_variance)) {
+			stable = delay;
+			break;
+		}
+		unstable = delay;
+	}
+
+	if (delay > 255) {
+		// nothing up to 128 was stable, try the maximum
+		stable = 255;
+	} else if (stable > 1) {
+		while (stable - unstable > 1) {
+			delay = (stable + unstable) / 2;
+			SetMuxDelay(delay);
+			if (MuxDelayIsStable(channels, samples, max_variance)) {
+				stable = delay;
+			} else {
+				unstable = delay;
+			}
+		}
+	}
+
+	SetMuxDelay(stable);
+	return stable;
+}
+
+// learned thermistor excitation ---------------------------------------------
+// Autoranging makes the chip find a current range on every thermistor conversion. While
+// calibrating, every valid thermistor result, whichever way it was measured, updates the
+// channel's coldest reading; calibration should run across the expected operating range.
+void LTC2983Manager::StartExcitationCalibration(void) {
+	uint8_t channel;
+
+	for (channel = 1; channel < 21; channel++) {
+		_therm_coldest[channel] = INT32_MAX;
+	}
+
+	_excitation_calibrating = true;
+}
+
+// Programs each observed thermistor channel with the largest fixed current that keeps
+// THERMISTOR_EXCITATION_MARGIN times its largest resistance (at its coldest) below
+// THERMISTOR_MAX_EXCITATION_VOLTAGE. A channel goes back to autorange by itself as
+// soon as a reading is out of range. Returns the number of channels reprogrammed.
+uint8_t LTC2983Manager::FinishExcitationCalibration(void) {
+	// currents in amps for THERMISTOR_EXCITATION_CURRENT__250NA (code 1) to __1MA (code 11)
+	static const float currents[11] = {250e-9f, 500e-9f, 1e-6f, 5e-6f, 10e-6f, 25e-6f, 50e-6f, 100e-6f, 250e-6f, 500e-6f, 1e-3f};
+	uint8_t channel, code;
+	uint8_t programmed = 0;
+	float r_max;
+
+	if (!_excitation_calibrating) return 0;
+	_excitation_calibrating = false;
+
+	for (channel = 1; channel < 21; channel++) {
+		if (channel_assignments[channel] != THERMISTOR_44006 || _therm_coldest[channel] == INT32_MAX) continue;
+
+		r_max = ThermistorResistance(_therm_coldest[channel]);
+		for (code = 11; code > 0; code--) {
+			if (currents[code - 1] * r_max * THERMISTOR_EXCITATION_MARGIN <= THERMISTOR_MAX_EXCITATION_VOLTAGE) break;
+		}
+		if (code == 0) continue; // even the smallest current is too large, keep autorange
+
+		SetThermistorExcitation(channel, code);
+		programmed++;
+	}
+
+	return programmed;
+}
+
+void LTC2983Manager::ResetExcitation(void) {
+	uint8_t channel;
+
+	_excitation_calibrating = false;
+	_excitation_fallbacks = LTC2983ChannelSet::None();
+	for (channel = 1; channel < 21; channel++) {
+		SetThermistorExcitation(channel, EXCITATION_CODE_AUTORANGE);
+	}
+}
+
+// lazy results ---------------------------------------------------------------
+// Completes a StartSweep() without reading any results: once the chip is done, the
+// swept channels become available through GetResult() and FetchResults()
+bool LTC2983Manager::CompleteSweepLazily(void) {
+	if (!FinishedMeasurement()) return false;
+
+	CompletionTime(&_lazy_completed_ms, &_lazy_completed_us);
+	_measurement_finished = false;
+	_lazy_pending = _sweep_channels;
+	_lazy_valid = LTC2983ChannelSet::None();
+	_sweep_channels = LTC2983ChannelSet::None();
+	_in_flight = -1;
+	return true;
+}
+
+void LTC2983Manager::MeasureSweepLazy(LTC2983ChannelSet channels) {
+	StartSweep(channels);
+	if (_wait_mode == WAIT_LOW_POWER) {
+		WaitForConversion();
+	} else {
+		delay(EstimateSweepDuration(_sweep_channels) / 1000);
+	}
+
+	while (!CompleteSweepLazily()) {
+		delay(SWEEP_POLL_INTERVAL_MS);
+	}
+
+	EndOfSweep();
+}
+
+// Returns the channel's result from the last lazy sweep, reading it from the chip the
+// first time it is asked for. Channels not in that sweep return their last stored value.
+float LTC2983Manager::GetResult(uint8_t channel_number) {
+	if (_lazy_pending.Contains(channel_number) && !_lazy_valid.Contains(channel_number)) {
+		_lazy_valid.Add(channel_number);
+		HandleResult(channel_number, get_raw_result(_chip_select_pin, channel_number), _lazy_completed_ms, _lazy_completed_us);
+	}
+
+	return channel_temperatures[channel_number];
+}
+
+// Decodes every requested channel of the last lazy sweep that has not been read yet,
+// with a single burst spanning the lowest to the highest of them
+void LTC2983Manager::FetchResults(LTC2983ChannelSet channels) {
+	uint8_t buffer[80];
+	LTC2983ChannelSet wanted = (channels & _lazy_pending) - _lazy_valid;
+	uint8_t * word;
+
+	if (wanted.Empty()) return;
+
+	uint8_t first = wanted.First();
+	transfer_ram_block(_chip_select_pin, READ_FROM_RAM, get_start_address(CONVERSION_RESULT_MEMORY_BASE, first), buffer, 4 * (wanted.Last() - first + 1));
+
+	for (uint8_t channel : wanted) {
+		word = &buffer[4 * (channel - first)];
+		HandleResult(channel, (uint32_t) word[0] << 24 | (uint32_t) word[1] << 16 | (uint32_t) word[2] << 8 | (uint32_t) word[3], _lazy_completed_ms, _lazy_completed_us);
+	}
+
+	_lazy_valid |= wanted;
+}
+
+// burst capture ----------------------------------------------------------------
+// Converts one channel back-to-back count times, storing the raw result word and
+// completion time of each conversion. Every result read is paired with the next start
+// command in one SPI transaction, and nothing is decoded or dispatched until the burst
+// is over, so the chip's conversion time is the only limit on the rate. The channel
+// configuration is untouched, normal sweeps can follow directly. Returns the number of
+// samples captured.
+uint16_t LTC2983Manager::CaptureChannel(uint8_t channel_number, CaptureSample_t * samples, uint16_t count) {
+	uint16_t i;
+
+	if (count == 0 || !IsMeasurable(channel_number)) return 0;
+	if (_sleeping) WakeUp();
+
+	StartMeasurement(channel_number);
+	for (i = 0; i < count; i++) {
+		WaitForConversion();
+		samples[i].timestamp_us = micros();
+		_measurement_finished = false; // before the next start, so its interrupt is not lost
+
+		if (i + 1 < count) {
+			samples[i].raw_result = get_raw_result_and_convert(_chip_select_pin, channel_number, channel_number);
+		} else {
+			samples[i].raw_result = get_raw_result(_chip_select_pin, channel_number);
+		}
+	}
+	_in_flight = -1;
+
+	return count;
+}
+
+// event subscriptions ---------------------------------------------------------
+// Registers handler for the EVENT_ bits in event_mask on channels. Returns a
+// subscription id, or -1 if all LTC2983_MAX_SUBSCRIBERS slots are taken.
+int8_t LTC2983Manager::Subscribe(LTC2983ChannelSet channels, uint8_t event_mask, EventHandler_t handler, void * context) {
+	uint8_t i;
+
+	if (channels.Empty() || event_mask == 0 || handler == NULL) return -1;
+
+	for (i = 0; i < LTC2983_MAX_SUBSCRIBERS; i++) {
+		if (_subscriptions[i].channels.Empty()) {
+			_subscriptions[i].event_mask = event_mask;
+			_subscriptions[i].handler = handler;
+			_subscriptions[i].context = context;
+			_subscriptions[i].channels = channels;
+			_subscribed_events |= event_mask;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void LTC2983Manager::Unsubscribe(int8_t subscription_id) {
+	uint8_t i;
+
+	if (subscription_id < 0 || subscription_id >= LTC2983_MAX_SUBSCRIBERS) return;
+	_subscriptions[subscription_id].channels = LTC2983ChannelSet::None();
+
+	_subscribed_events = 0;
+	for (i = 0; i < LTC2983_MAX_SUBSCRIBERS; i++) {
+		if (!_subscriptions[i].channels.Empty()) _subscribed_events |= _subscriptions[i].event_mask;
+	}
+}
+
+// temperature alarms ---------------------------------------------------------
+// Limits are in the configured temperature unit. A channel enters ALARM_HIGH above
+// high (ALARM_LOW below low) and only leaves it once the reading is back inside the
+// limit by at least hysteresis.
+void LTC2983Manager::SetAlarm(uint8_t channel_number, float low, float high, float hysteresis) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	Alarm_t * alarm = &_alarms[channel_number];
+	alarm->low = (int32_t) (low * 1024);
+	alarm->high = (int32_t) (high * 1024);
+	alarm->hysteresis = (int32_t) (hysteresis * 1024);
+	alarm->state = ALARM_NONE;
+	alarm->enabled = true;
+	_alarm_flags.Remove(channel_number);
+}
+
+void LTC2983Manager::ClearAlarm(uint8_t channel_number) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	_alarms[channel_number].enabled = false;
+	_alarms[channel_number].state = ALARM_NONE;
+	_alarm_flags.Remove(channel_number);
+}
+
+// Priority channels are converted again every ALARM_PRIORITY_INTERLEAVE channels of a
+// MeasureAllChannels() sweep while they are in alarm
+void LTC2983Manager::SetAlarmPriority(uint8_t channel_number, bool priority) {
+	if (channel_number < 1 || channel_number > 20) return;
+
+	_alarms[channel_number].priority = priority;
+}
+
+// adaptive sampling ----------------------------------------------------------
+// Each measurable channel gets a sample period between min_period_ms and
+// max_period_ms. A channel whose average rate of change (degrees per second) rises
+// above rate_threshold has its period halved; below half the threshold, its period
+// grows by a quarter. MeasureAllChannels() then only converts the channels that are due.
+void LTC2983Manager::EnableAdaptiveSampling(uint32_t min_period_ms, uint32_t max_period_ms, float rate_threshold) {
+	uint8_t channel;
+
+	if (max_period_ms < min_period_ms) max_period_ms = min_period_ms;
+
+	_adaptive_min_period_ms = min_period_ms;
+	_adaptive_max_period_ms = max_period_ms;
+	_adaptive_rate_threshold = (uint32_t) (rate_threshold * 1024);
+
+	// start every channel at the fastest rate until its dynamics are known
+	for (channel = 1; channel < 21; channel++) {
+		_adaptive[channel].primed = false;
+		_adaptive[channel].rate = 0;
+		_adaptive[channel].period_ms = min_period_ms;
+	}
+
+	_adaptive_enabled = true;
+}
+
+// Returns the measurable channels whose sample period has elapsed
+LTC2983ChannelSet LTC2983Manager::DueChannels(uint32_t now_ms) {
+	LTC2983ChannelSet due;
+
+	for (uint8_t channel : MeasurableChannels()) {
+		AdaptiveChannel_t * adaptive = &_adaptive[channel];
+		if (!adaptive->primed || now_ms - adaptive->last_time_ms >= adaptive->period_ms) {
+			due.Add(channel);
+		}
+	}
+
+	return due;
+}
+
+// configuration profiles -----------------------------------------------------
+// Stores a named profile built from an assignment array laid out like
+// channel_assignments[21], using the current global configuration and MUX delay.
+// Redefining an existing name overwrites it. Returns the profile index, or -1 if the
+// profile table is full.
+int8_t LTC2983Manager::DefineProfile(const char * name, const Sensor_Type_t assignments[21]) {
+	int8_t index = FindProfile(name);
+	uint8_t i;
+
+	if (index < 0) {
+		for (i = 0; i < LTC2983_MAX_PROFILES; i++) {
+			if (!_profiles[i].defined) {
+				index = i;
+				break;
+			}
+		}
+	}
+	if (index < 0) return -1;
+
+	LTC2983Profile_t * profile = &_profiles[index];
+	strncpy(profile->name, name, LTC2983_PROFILE_NAME_LENGTH - 1);
+	profile->name[LTC2983_PROFILE_NAME_LENGTH - 1] = '\0';
+	profile->global_config = _global_config;
+	profile->mux_delay = _mux_delay;
+	profile->channel_assignments[0] = UNUSED_CHANNEL;
+	profile->channel_words[0] = 0;
+	for (i = 1; i < 21; i++) {
+		profile->channel_assignments[i] = assignments[i];
+		profile->channel_words[i] = ChannelWord(assignments[i], i);
+	}
+	profile->defined = true;
+
+	// the active profile's registers may now differ from the chip, so force a resync
+	if (index == _active_profile) _active_profile = -1;
+
+	return index;
+}
+
+bool LTC2983Manager::SwitchProfile(const char * name) {
+	int8_t index = FindProfile(name);
+	if (index < 0) return false;
+	return SwitchProfile((uint8_t) index);
+}
+
+// Moves the chip to a stored profile, writing only the registers that differ from the
+// current configuration. Runs of changed channel words are sent as single bursts;
+// an unchanged word between two changed ones is resent rather than starting a new frame.
+bool LTC2983Manager::SwitchProfile(uint8_t profile_index) {
+	if (profile_index >= LTC2983_MAX_PROFILES || !_profiles[profile_index].defined) return false;
+	if (_sleeping) WakeUp();
+
+	LTC2983Profile_t * profile = &_profiles[profile_index];
+	uint8_t channel;
+	uint8_t run_start = 0; // first channel of the pending burst, 0 if none
+	uint8_t run_end = 0;
+
+	if (profile->global_config != _global_config) {
+		_global_config = profile->global_config;
+		transfer_byte(_chip_select_pin, WRITE_TO_RAM, GLOBAL_CONFIGURATION_REGISTER, _global_config);
+	}
+	if (profile->mux_delay != _mux_delay) {
+		_mux_delay = profile->mux_delay;
+		transfer_byte(_chip_select_pin, WRITE_TO_RAM, MUX_CONFIGURATION_REGISTER, _mux_delay);
+	}
+
+	for (channel = 1; channel < 21; channel++) {
+		channel_assignments[channel] = profile->channel_assignments[channel];
+		if (profile->channel_words[channel] == _channel_words[channel]) continue;
+
+		_channel_words[channel] = profile->channel_words[channel];
+		if (run_start != 0 && channel - run_end > 2) {
+			WriteChannelWords(run_start, run_end);
+			run_start = 0;
+		}
+		if (run_start == 0) run_start = channel;
+		run_end = channel;
+	}
+	if (run_start != 0) WriteChannelWords(run_start, run_end);
+
+	UpdateConfigCrc();
+	_active_profile = profile_index;
+	_words_loaded = false;
+	return true;
+}
+
+// configuration integrity -----------------------------------------------------
+// Reads back the global and channel assignment RAM in two bursts and compares its CRC
+// with that of the expected configuration. On a mismatch, only the differing registers
+// are rewritten. Must not be called while a conversion is in progress. Returns the
+// number of registers (bytes or channel words) that were repaired.
+uint8_t LTC2983Manager::CheckConfiguration(void) {
+	if (_sleeping) return 0; // a reset and full configure happen on wake up anyway
+
+	uint8_t global_ram[16]; // 0x0F0-0x0FF
+	uint8_t channel_ram[80]; // 0x200-0x24F
+	uint8_t expected[4];
+	uint8_t channel;
+	uint8_t repaired = 0;
+	uint16_t crc;
+
+	transfer_ram_block(_chip_select_pin, READ_FROM_RAM, GLOBAL_CONFIGURATION_REGISTER, global_ram, sizeof(global_ram));
+	transfer_ram_block(_chip_select_pin, READ_FROM_RAM, CH_ADDRESS_BASE, channel_ram, sizeof(channel_ram));
+
+	crc = crc16_ccitt(&global_ram[0], 1, 0xFFFF);
+	crc = crc16_ccitt(&global_ram[MUX_CONFIGURATION_REGISTER - GLOBAL_CONFIGURATION_REGISTER], 1, crc);
+	crc = crc16_ccitt(channel_ram, sizeof(channel_ram), crc);
+	if (crc == _config_crc) return 0;
+
+	if (global_ram[0] != _global_config) {
+		transfer_byte(_chip_select_pin, WRITE_TO_RAM, GLOBAL_CONFIGURATION_REGISTER, _global_config);
+		repaired++;
+	}
+	if (global_ram[MUX_CONFIGURATION_REGISTER - GLOBAL_CONFIGURATION_REGISTER] != _mux_delay) {
+		transfer_byte(_chip_select_pin, WRITE_TO_RAM, MUX_CONFIGURATION_REGISTER, _mux_delay);
+		repaired++;
+	}
+	for (channel = 1; channel < 21; channel++) {
+		PackChannelWords(expected, channel, channel);
+		if (memcmp(expected, &channel_ram[4 * (channel - 1)], 4) != 0) {
+			WriteChannelWords(channel, channel);
+			repaired++;
+		}
+	}
+
+	_configuration_repairs += repaired;
+	return repaired;
+}
+
+// Runs CheckConfiguration() after every sweeps completed sweeps, 0 disables
+void LTC2983Manager::SetIntegrityCheckInterval(uint16_t sweeps) {
+	_integrity_check_interval = sweeps;
+	_sweeps_since_check = 0;
+}
+
+// configuration images -------------------------------------------------------
+// Serializes the current configuration into buffer, returns the image size or 0 if
+// the buffer is too small
+uint16_t LTC2983Manager::SaveConfigImage(uint8_t * buffer, uint16_t buffer_length) {
+	if (buffer_length < LTC2983_CONFIG_IMAGE_SIZE) return 0;
+
+	buffer[0] = 'L';
+	buffer[1] = 'T';
+	buffer[2] = LTC2983_CONFIG_IMAGE_VERSION;
+	buffer[3] = _global_config;
+	buffer[4] = _mux_delay;
+	buffer[5] = 0;
+	PackChannelWords(buffer + CONFIG_IMAGE_CHANNELS_OFFSET, 1, 20);
+
+	uint16_t crc = crc16_ccitt(buffer, CONFIG_IMAGE_CRC_OFFSET, 0xFFFF);
+	buffer[CONFIG_IMAGE_CRC_OFFSET] = highByte(crc);
+	buffer[CONFIG_IMAGE_CRC_OFFSET + 1] = lowByte(crc);
+
+	return LTC2983_CONFIG_IMAGE_SIZE;
+}
+
+// Validates an image and writes it to the chip. Nothing is written unless the magic,
+// version and CRC all check out. Channels with sensor types outside Sensor_Type_t are
+// configured on the chip but left UNUSED_CHANNEL in channel_assignments[]. The loaded
+// words, not channel_assignments[], are what Configure() restores after a wake up.
+bool LTC2983Manager::LoadConfigImage(const uint8_t * buffer, uint16_t length) {
+	if (length < LTC2983_CONFIG_IMAGE_SIZE) return false;
+	if (buffer[0] != 'L' || buffer[1] != 'T' || buffer[2] != LTC2983_CONFIG_IMAGE_VERSION) return false;
+
+	uint16_t crc = crc16_ccitt(buffer, CONFIG_IMAGE_CRC_OFFSET, 0xFFFF);
+	if (buffer[CONFIG_IMAGE_CRC_OFFSET] != highByte(crc) || buffer[CONFIG_IMAGE_CRC_OFFSET + 1] != lowByte(crc)) return false;
+
+	if (_sleeping) WakeUp();
+
+	uint8_t channel;
+	const uint8_t * words = buffer + CONFIG_IMAGE_CHANNELS_OFFSET;
+	uint8_t channel_ram[80];
+
+	_global_config = buffer[3];
+	_mux_delay = buffer[4];
+	for (channel = 1; channel < 21; channel++) {
+		_channel_words[channel] = (uint32_t) words[0] << 24 | (uint32_t) words[1] << 16 | (uint32_t) words[2] << 8 | (uint32_t) words[3];
+		channel_assignments[channel] = AssignmentFromWord(_channel_words[channel]);
+		if (channel_assignments[channel] == THERMISTOR_44006) {
+			_therm_excitation[channel] = (uint8_t) ((_channel_words[channel] & THERMISTOR_EXCITATION_CURRENT_MASK) >> THERMISTOR_EXCITATION_CURRENT_LSB);
+		}
+		words += 4;
+	}
+
+	// transfer_ram_block reads back into its buffer, so send a copy of the image
+	memcpy(channel_ram, buffer + CONFIG_IMAGE_CHANNELS_OFFSET, sizeof(channel_ram));
+	transfer_byte(_chip_select_pin, WRITE_TO_RAM, GLOBAL_CONFIGURATION_REGISTER, _global_config);
+	transfer_byte(_chip_select_pin, WRITE_TO_RAM, MUX_CONFIGURATION_REGISTER, _mux_delay);
+	transfer_ram_block(_chip_select_pin, WRITE_TO_RAM, CH_ADDRESS_BASE, channel_ram, sizeof(channel_ram));
+
+	UpdateConfigCrc();
+	_active_profile = -1;
+	_words_loaded = true;
+	return true;
+}
+
+bool LTC2983Manager::SaveConfigImageToEEPROM(int address) {
+	uint8_t image[LTC2983_CONFIG_IMAGE_SIZE];
+	uint16_t i;
+
+	if (address < 0 || address + LTC2983_CONFIG_IMAGE_SIZE > EEPROM.length()) return false;
+
+	SaveConfigImage(image, sizeof(image));
+	for (i = 0; i < LTC2983_CONFIG_IMAGE_SIZE; i++) {
+		EEPROM.update(address + i, image[i]); // only rewrites bytes that changed
+	}
+
+	return true;
+}
+
+bool LTC2983Manager::LoadConfigImageFromEEPROM(int address) {
+	uint8_t image[LTC2983_CONFIG_IMAGE_SIZE];
+	uint16_t i;
+
+	if (address < 0 || address + LTC2983_CONFIG_IMAGE_SIZE > EEPROM.length()) return false;
+
+	for (i = 0; i < LTC2983_CONFIG_IMAGE_SIZE; i++) {
+		image[i] = EEPROM.read(address + i);
+	}
+
+	return LoadConfigImage(image, sizeof(image));
+}
+
 // old methods ----------------------------------------------------------------
 // Depreciate; new resetSpi function assumes port0
 /* void LTC2983Manager::setSpi(uint8_t port_number){
@@ -189,44 +1080,430 @@ void LTC2983Manager::connect(){
 }
 
 // Private methods ------------------------------------------------------------
+// completed_ms and completed_us are when the conversion was seen to finish, which for
+// lazily read results can be long before the decode
+float LTC2983Manager::HandleResult(uint8_t channel_number, uint32_t raw_result, uint32_t completed_ms, uint32_t completed_us) {
+	int32_t fixed_temperature = raw_result_to_fixed(raw_result);
+	float temp = float(fixed_temperature) / 1024;
+	uint8_t fault_byte = raw_result >> 24;
+
+	channel_temperatures[channel_number] = temp;
+	_result_time_ms[channel_number] = completed_ms;
+	_has_result.Add(channel_number);
+
+	if (_subscribed_events != 0) {
+		_event.type = ((fault_byte & VALID) && !(fault_byte & ~VALID)) ? EVENT_RESULT : EVENT_FAULT;
+		_event.channel_number = channel_number;
+		_event.fault_byte = fault_byte;
+		_event.alarm_state = _alarms[channel_number].state;
+		_event.fixed_temperature = fixed_temperature;
+		_event.temperature = temp;
+		_event.timestamp_us = completed_us;
+		Dispatch(&_event);
+	}
+
+	// readings the chip flags as invalid must not trip or clear an alarm
+	if (_alarms[channel_number].enabled && (fault_byte & VALID)) {
+		EvaluateAlarm(channel_number, fixed_temperature);
+	}
+
+	// results on every path count towards calibration, without touching the chip
+	if (_excitation_calibrating && (fault_byte & VALID) && channel_assignments[channel_number] == THERMISTOR_44006 &&
+		fixed_temperature < _therm_coldest[channel_number]) {
+		_therm_coldest[channel_number] = fixed_temperature;
+	}
+
+	// a fixed excitation current that no longer fits the sensor falls back to autorange
+	if ((fault_byte & (SENSOR_ABOVE | SENSOR_BELOW | ADC_RANGE_ERROR)) &&
+		_therm_excitation[channel_number] != (EXCITATION_CODE_AUTORANGE)) {
+		_excitation_fallbacks.Add(channel_number);
+	}
+
+	if (_adaptive_enabled && (fault_byte & VALID)) {
+		UpdateAdaptiveRate(channel_number, fixed_temperature, completed_ms);
+	}
+
+	if (_estimator != NULL && (fault_byte & VALID)) {
+		_estimator->Update(channel_number, temp, completed_ms);
+	}
+
+	if (_decimator != NULL && (fault_byte & VALID)) {
+		_decimator->Push(channel_number, fixed_temperature);
+	}
+
+	if (_history != NULL && (fault_byte & VALID)) {
+		_history->Push(channel_number, fixed_temperature, _result_time_ms[channel_number]);
+	}
+
+	if (_quantile_sketch != NULL && (fault_byte & VALID)) {
+		_quantile_sketch->Push(channel_number, fixed_temperature);
+	}
+
+	return temp;
+}
+
+void LTC2983Manager::EvaluateAlarm(uint8_t channel_number, int32_t fixed_temperature) {
+	Alarm_t * alarm = &_alarms[channel_number];
+	Alarm_State_t state = alarm->state;
+
+	switch (state) {
+	case ALARM_NONE:
+		if (fixed_temperature > alarm->high) state = ALARM_HIGH;
+		else if (fixed_temperature < alarm->low) state = ALARM_LOW;
+		break;
+	case ALARM_HIGH:
+		if (fixed_temperature < alarm->high - alarm->hysteresis) {
+			state = (fixed_temperature < alarm->low) ? ALARM_LOW : ALARM_NONE;
+		}
+		break;
+	case ALARM_LOW:
+		if (fixed_temperature > alarm->low + alarm->hysteresis) {
+			state = (fixed_temperature > alarm->high) ? ALARM_HIGH : ALARM_NONE;
+		}
+		break;
+	}
+
+	if (state == alarm->state) return;
+
+	alarm->state = state;
+	if (state == ALARM_NONE) {
+		_alarm_flags.Remove(channel_number);
+	} else {
+		_alarm_flags.Add(channel_number);
+	}
+
+	if (_alarm_callback != NULL) _alarm_callback(channel_number, state, channel_temperatures[channel_number]);
+
+	// HandleResult() has already filled in _event if anyone is subscribed
+	if (_subscribed_events & EVENT_ALARM) {
+		_event.type = EVENT_ALARM;
+		_event.alarm_state = state;
+		Dispatch(&_event);
+	}
+}
+
+// calls each matching handler, cost is bounded by LTC2983_MAX_SUBSCRIBERS
+void LTC2983Manager::Dispatch(const LTC2983Event_t * event) {
+	uint8_t i;
+
+	if (!(_subscribed_events & event->type)) return;
+
+	for (i = 0; i < LTC2983_MAX_SUBSCRIBERS; i++) {
+		if (_subscriptions[i].channels.Contains(event->channel_number) && (_subscriptions[i].event_mask & event->type)) {
+			_subscriptions[i].handler(_subscriptions[i].context, event);
+		}
+	}
+}
+
+void LTC2983Manager::UpdateAdaptiveRate(uint8_t channel_number, int32_t fixed_temperature, uint32_t now_ms) {
+	AdaptiveChannel_t * adaptive = &_adaptive[channel_number];
+	uint32_t elapsed_ms = now_ms - adaptive->last_time_ms;
+	int32_t change = fixed_temperature - adaptive->last_value;
+	uint32_t rate;
+
+	if (adaptive->primed && elapsed_ms > 0) {
+		if (change < 0) change = -change;
+		rate = (uint32_t) (((uint64_t) change * 1000) / elapsed_ms);
+		adaptive->rate += ((int32_t) rate - (int32_t) adaptive->rate) >> ADAPTIVE_RATE_SHIFT;
+
+		if (adaptive->rate > _adaptive_rate_threshold) {
+			adaptive->period_ms /= 2;
+			if (adaptive->period_ms < _adaptive_min_period_ms) adaptive->period_ms = _adaptive_min_period_ms;
+		} else if (adaptive->rate < _adaptive_rate_threshold / 2) {
+			adaptive->period_ms += adaptive->period_ms / 4 + 1;
+			if (adaptive->period_ms > _adaptive_max_period_ms) adaptive->period_ms = _adaptive_max_period_ms;
+		}
+	}
+
+	adaptive->primed = true;
+	adaptive->last_value = fixed_temperature;
+	adaptive->last_time_ms = now_ms;
+}
+
+// only thermistor and RTD channels produce temperatures
+bool LTC2983Manager::IsMeasurable(uint8_t channel_number) {
+	Sensor_Type_t assignment = channel_assignments[channel_number];
+	return (assignment == THERMISTOR_44006 || assignment == RTD_PT_100);
+}
+
+// channel_assignments is public and may change at any time, so this is not cached
+LTC2983ChannelSet LTC2983Manager::MeasurableChannels(void) {
+	LTC2983ChannelSet measurable;
+	uint8_t channel;
+
+	for (channel = 1; channel < 21; channel++) {
+		if (IsMeasurable(channel)) measurable.Add(channel);
+	}
+
+	return measurable;
+}
+
+// the chip is idle between sweeps, so this is the cheapest time to verify its RAM
+void LTC2983Manager::EndOfSweep(void) {
+	if (!_excitation_fallbacks.Empty()) ApplyExcitationFallbacks();
+
+	if (_integrity_check_interval > 0 && ++_sweeps_since_check >= _integrity_check_interval) {
+		_sweeps_since_check = 0;
+		CheckConfiguration();
+	}
+}
+
+// Updates a channel's excitation current everywhere it is stored: the chip (if the
+// channel is a thermistor), the configuration shadow and CRC, and any profile that
+// uses a thermistor on that channel
+void LTC2983Manager::SetThermistorExcitation(uint8_t channel_number, uint8_t current_code) {
+	uint8_t profile;
+
+	if (_therm_excitation[channel_number] == current_code) return;
+	_therm_excitation[channel_number] = current_code;
+
+	for (profile = 0; profile < LTC2983_MAX_PROFILES; profile++) {
+		if (_profiles[profile].defined && _profiles[profile].channel_assignments[channel_number] == THERMISTOR_44006) {
+			_profiles[profile].channel_words[channel_number] = ThermistorWord(channel_number);
+		}
+	}
+
+	if (channel_assignments[channel_number] == THERMISTOR_44006) {
+		// only the current field changes, so a loaded word keeps its other settings
+		_channel_words[channel_number] = (_channel_words[channel_number] & ~THERMISTOR_EXCITATION_CURRENT_MASK) |
+			((uint32_t) current_code << THERMISTOR_EXCITATION_CURRENT_LSB);
+		WriteChannelWords(channel_number, channel_number);
+		UpdateConfigCrc();
+	}
+}
+
+// must only be called while the chip is idle, since it writes configuration RAM
+void LTC2983Manager::ApplyExcitationFallbacks(void) {
+	for (uint8_t channel : _excitation_fallbacks) {
+		SetThermistorExcitation(channel, EXCITATION_CODE_AUTORANGE);
+	}
+
+	_excitation_fallbacks = LTC2983ChannelSet::None();
+}
+
+// When the conversion being read finished: the time InterruptHandler() recorded if it
+// ran, otherwise now, the first time completion is observed
+void LTC2983Manager::CompletionTime(uint32_t * completed_ms, uint32_t * completed_us) {
+	if (_measurement_finished) {
+		*completed_ms = _finished_ms;
+		*completed_us = _finished_us;
+	} else {
+		*completed_ms = millis();
+		*completed_us = micros();
+	}
+}
+
+// Inverts the 44006 Steinhart-Hart equation 1/T = A + B x + C x^3 for x = ln(R), a
+// depressed cubic with a single real root (Cardano's formula)
+float LTC2983Manager::ThermistorResistance(int32_t fixed_temperature) {
+	float celsius = float(fixed_temperature) / 1024;
+	if (_global_config & TEMP_UNIT__F) celsius = (celsius - 32.0f) * 5.0f / 9.0f;
+
+	float y = (THERMISTOR_44006_A - 1.0f / (celsius + 273.15f)) / THERMISTOR_44006_C;
+	float p = THERMISTOR_44006_B / (3.0f * THERMISTOR_44006_C);
+	float x = sqrtf(p * p * p + y * y / 4);
+
+	return expf(cbrtf(x - y / 2) - cbrtf(x + y / 2));
+}
+
+// Measures the channels in channels samples times in sequence and checks each
+// channel's variance (in 1/1024 degree units squared) against max_variance. The trial
+// readings are deliberately unsettled, so like CaptureChannel() they are read as raw
+// words and never reach the result path (alarms, subscribers, history, learning). A
+// reading the chip flags as invalid counts as unstable.
+bool LTC2983Manager::MuxDelayIsStable(LTC2983ChannelSet channels, uint8_t samples, int64_t max_variance) {
+	int64_t sum[21];
+	int64_t sum_squares[21];
+	uint32_t raw_result;
+	int32_t value;
+	uint8_t sample;
+
+	for (uint8_t channel : channels) {
+		sum[channel] = 0;
+		sum_squares[channel] = 0;
+	}
+
+	for (sample = 0; sample < samples; sample++) {
+		for (uint8_t channel : channels) {
+			StartMeasurement(channel);
+			WaitForConversion();
+			_measurement_finished = false;
+			_in_flight = -1;
+
+			raw_result = get_raw_result(_chip_select_pin, channel);
+			if (!((raw_result >> 24) & VALID)) return false;
+
+			value = raw_result_to_fixed(raw_result);
+			sum[channel] += value;
+			sum_squares[channel] += (int64_t) value * value;
+		}
+	}
+
+	// n * sum(x^2) - sum(x)^2 = n^2 * variance
+	for (uint8_t channel : channels) {
+		if (samples * sum_squares[channel] - sum[channel] * sum[channel] > max_variance * samples * samples) return false;
+	}
+
+	return true;
+}
+
+// Folds a timed conversion into the table for the current rejection mode. The MUX
+// delay is taken out so the table holds the pure conversion time.
+void LTC2983Manager::LearnConversionTime(uint32_t elapsed_us, uint8_t conversions) {
+	if (conversions == 0) return;
+
+	int32_t per_channel_us = elapsed_us / conversions - (uint32_t) _mux_delay * 100;
+	uint32_t * table = &_conversion_time_us[_global_config & 0x3];
+
+	if (_conversion_time_pinned & (1 << (_global_config & 0x3))) return;
+	if (per_channel_us <= 0) return;
+	*table += (per_channel_us - (int32_t) *table) >> CONVERSION_TIME_SHIFT;
+}
+
+// Every blocking method waits here (sweeps only in WAIT_LOW_POWER, they poll otherwise).
+// Once the conversion should be over, the status register is read after each idle too,
+// so a missed or unwired interrupt costs one idle period instead of hanging the wait.
+void LTC2983Manager::WaitForConversion(void) {
+	if (_wait_mode == WAIT_POLL) {
+		wait_for_process_to_finish(_chip_select_pin);
+		return;
+	}
+
+	uint32_t start_us = micros();
+	uint32_t expected_us = (_in_flight == 0) ? EstimateSweepDuration(_sweep_channels) :
+		_conversion_time_us[_global_config & 0x3] + (uint32_t) _mux_delay * 100;
+
+	while (!_measurement_finished) {
+		_idle_time_us += (_idle_handler != NULL) ? _idle_handler(_idle_context) : IdleUntilInterrupt();
+
+		if (!_measurement_finished && micros() - start_us >= expected_us && FinishedMeasurement()) {
+			InterruptHandler(); // as if the missed interrupt had arrived now
+		}
+	}
+}
+
+// Cortex-M only: interrupts are masked around the flag check so one arriving in between
+// stays pending and ends the WFI at once instead of being missed. On other targets this
+// returns immediately and the wait degrades to spinning on the flag.
+uint32_t LTC2983Manager::IdleUntilInterrupt(void) {
+	uint32_t start_us = micros();
+
+#if defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+	__asm__ volatile ("cpsid i" ::: "memory");
+	if (!_measurement_finished) __asm__ volatile ("wfi");
+	__asm__ volatile ("cpsie i" ::: "memory");
+#endif
+
+	return micros() - start_us;
+}
+
+void LTC2983Manager::MeasurePriorityAlarms(void) {
+	// iterates over a snapshot, measuring may clear alarms
+	for (uint8_t channel : _alarm_flags) {
+		if (_alarms[channel].priority) MeasureChannel(channel);
+	}
+}
+
 void LTC2983Manager::Configure(void) {// chip configurations
 	if (_sleeping) WakeUp();
-	transfer_byte(_chip_select_pin, WRITE_TO_RAM, 0xF0, TEMP_UNIT__C | REJECTION__50_60_HZ);
-	transfer_byte(_chip_select_pin, WRITE_TO_RAM, 0xFF, 0); // conversion delay = 0 us
+	transfer_byte(_chip_select_pin, WRITE_TO_RAM, GLOBAL_CONFIGURATION_REGISTER, _global_config);
+	transfer_byte(_chip_select_pin, WRITE_TO_RAM, MUX_CONFIGURATION_REGISTER, _mux_delay);
 
-	// channel configuration
+	// channel configuration, all 20 channels in one burst; a loaded image is resent as is
 	uint8_t channel;
-	for (channel = 1; channel < 21; channel++) {
-		switch (channel_assignments[channel]) {
-		case UNUSED_CHANNEL:
-			break; // nothing to do
-		case SENSE_RESISTOR_1000:
-			AssignSenseResistor(channel);
-			break;
-		case THERMISTOR_44006:
-			AssignThermistor(channel);
-			break;
-		case RTD_PT_100:
-			AssignRTD(channel);
-			break;
-		default:
-			Serial.println("LTC2983Manager error: unknown channel assignment");
-			break;
+	if (!_words_loaded) {
+		for (channel = 1; channel < 21; channel++) {
+			_channel_words[channel] = ChannelWord(channel_assignments[channel], channel);
+		}
+	}
+	WriteChannelWords(1, 20);
+	UpdateConfigCrc();
+	_active_profile = -1;
+}
+
+void LTC2983Manager::WriteChannelWords(uint8_t first_channel, uint8_t last_channel) {
+	uint8_t buffer[80]; // 20 channels * 4 bytes
+	uint8_t length = PackChannelWords(buffer, first_channel, last_channel);
+
+	transfer_ram_block(_chip_select_pin, WRITE_TO_RAM, get_start_address(CH_ADDRESS_BASE, first_channel), buffer, length);
+}
+
+// Copies _channel_words[first_channel..last_channel] into buffer in chip RAM order
+// (each word most significant byte first), returns the number of bytes written
+uint8_t LTC2983Manager::PackChannelWords(uint8_t * buffer, uint8_t first_channel, uint8_t last_channel) {
+	uint8_t channel;
+	uint8_t length = 0;
+
+	for (channel = first_channel; channel <= last_channel; channel++) {
+		buffer[length++] = (uint8_t) (_channel_words[channel] >> 24);
+		buffer[length++] = (uint8_t) (_channel_words[channel] >> 16);
+		buffer[length++] = (uint8_t) (_channel_words[channel] >> 8);
+		buffer[length++] = (uint8_t) _channel_words[channel];
+	}
+
+	return length;
+}
+
+// CRC of the expected configuration RAM, in the order CheckConfiguration() reads it
+void LTC2983Manager::UpdateConfigCrc(void) {
+	uint8_t channel_ram[80];
+
+	PackChannelWords(channel_ram, 1, 20);
+	_config_crc = crc16_ccitt(&_global_config, 1, 0xFFFF);
+	_config_crc = crc16_ccitt(&_mux_delay, 1, _config_crc);
+	_config_crc = crc16_ccitt(channel_ram, sizeof(channel_ram), _config_crc);
+}
+
+int8_t LTC2983Manager::FindProfile(const char * name) {
+	uint8_t i;
+	for (i = 0; i < LTC2983_MAX_PROFILES; i++) {
+		if (_profiles[i].defined && strncmp(_profiles[i].name, name, LTC2983_PROFILE_NAME_LENGTH - 1) == 0) {
+			return i;
 		}
 	}
+	return -1;
+}
+
+Sensor_Type_t LTC2983Manager::AssignmentFromWord(uint32_t channel_word) {
+	switch (channel_word & ((uint32_t) 0x1F << SENSOR_TYPE_LSB)) {
+	case SENSOR_TYPE__SENSE_RESISTOR:
+		return SENSE_RESISTOR_1000;
+	case SENSOR_TYPE__THERMISTOR_44006_10K_25C:
+		return THERMISTOR_44006;
+	case SENSOR_TYPE__RTD_PT_100:
+		return RTD_PT_100;
+	default:
+		return UNUSED_CHANNEL;
+	}
+}
+
+uint32_t LTC2983Manager::ChannelWord(Sensor_Type_t assignment, uint8_t channel_number) {
+	switch (assignment) {
+	case UNUSED_CHANNEL:
+		return 0; // nothing to do
+	case SENSE_RESISTOR_1000:
+		return SenseResistorWord();
+	case THERMISTOR_44006:
+		return ThermistorWord(channel_number);
+	case RTD_PT_100:
+		return RTDWord();
+	default:
+		Serial.println("LTC2983Manager error: unknown channel assignment");
+		return 0;
+	}
 }
 
-void LTC2983Manager::AssignSenseResistor(uint8_t channel_number) {
+uint32_t LTC2983Manager::SenseResistorWord(void) {
 	uint32_t channel_assignment_data;
 
 	channel_assignment_data = 
 		SENSOR_TYPE__SENSE_RESISTOR | 
 		SENSE_RESISTOR_1K;   // sense resistor - value: 1000.
 
-	assign_channel(_chip_select_pin, channel_number, channel_assignment_data);
+	return channel_assignment_data;
 }
 
-void LTC2983Manager::AssignThermistor(uint8_t channel_number) {
+uint32_t LTC2983Manager::ThermistorWord(uint8_t channel_number) {
 	uint32_t channel_assignment_data;
 
 	channel_assignment_data = 
@@ -234,12 +1511,12 @@ void LTC2983Manager::AssignThermistor(uint8_t channel_number) {
 		(_therm_sense_channel << THERMISTOR_RSENSE_CHANNEL_LSB) |
 		THERMISTOR_DIFFERENTIAL |
 		THERMISTOR_EXCITATION_MODE__SHARING_NO_ROTATION |
-		THERMISTOR_EXCITATION_CURRENT__AUTORANGE;
+		((uint32_t) _therm_excitation[channel_number] << THERMISTOR_EXCITATION_CURRENT_LSB); // autorange unless calibrated
 
-	assign_channel(_chip_select_pin, channel_number, channel_assignment_data);
+	return channel_assignment_data;
 }
 
-void LTC2983Manager::AssignRTD(uint8_t channel_number) {
+uint32_t LTC2983Manager::RTDWord(void) {
 	uint32_t channel_assignment_data;
 
 	channel_assignment_data = 
@@ -250,5 +1527,5 @@ void LTC2983Manager::AssignRTD(uint8_t channel_number) {
 		RTD_EXCITATION_CURRENT__50UA |
 		RTD_STANDARD__AMERICAN;
 
-	assign_channel(_chip_select_pin, channel_number, channel_assignment_data);
+	return channel_assignment_data;
 }
\ No newline at end of file
@@ -23,6 +23,11 @@
  *    3) Read sensors by calling MeasureAllChannels() or MeasureChannel(uint8_t)
  *    4) Results for valid, requested channels will be in channel_temperatures[21],
  *       and MeasureChannel(uint8_t) will also return the result
+ *    5) Optionally, preload alternate layouts with DefineProfile() and move between
+ *       them with SwitchProfile(), which only rewrites the registers that differ
+ *    6) The configuration can be saved to and restored from a binary image with
+ *       SaveConfigImage()/LoadConfigImage() or their EEPROM variants. A loaded image
+ *       stays the configuration (also after Sleep()/WakeUp()) until SwitchProfile()
  *
  *  Note: this class does not error check sensor configurations, ie. will not catch if a
  *        channel that is assigned to one sensor is then needed for differential input.
@@ -37,11 +42,18 @@
 #include "LTC2983_configuration_constants.h"
 #include "LTC2983_table_coeffs.h"
 #include "LTC2983_support_functions.h"
+#include "LTC2983Estimator.h"
+#include "LTC2983Decimator.h"
+#include "LTC2983History.h"
+#include "LTC2983QuantileSketch.h"
+#include "LTC2983ChannelSet.h"
 #include "Arduino.h"
 #include "HardwareSerial.h"
 #include "WProgram.h"
 #include "SPI.h"
+#include "EEPROM.h"
 #include <stdint.h>
+#include <string.h>
 
 #define TEMPERATURE_ERROR	-300.0f
 #define LTC_POWERED_OFF		-888.0f
@@ -58,6 +70,129 @@ enum Sensor_Type_t {
 	RTD_PT_100
 };
 
+#define LTC2983_MAX_PROFILES		4
+#define LTC2983_PROFILE_NAME_LENGTH	16
+
+// a preloaded configuration that can be switched to with SwitchProfile()
+struct LTC2983Profile_t {
+	bool defined;
+	char name[LTC2983_PROFILE_NAME_LENGTH];
+	uint8_t global_config;
+	uint8_t mux_delay;
+	Sensor_Type_t channel_assignments[21];
+	uint32_t channel_words[21]; // channel assignment words as written to the chip
+};
+
+// Binary configuration image, for storage in EEPROM/flash or upload over telemetry.
+// The channel block is a byte-for-byte copy of chip RAM 0x200-0x24F, so loading it is
+// a single burst write. Layout (LTC2983_CONFIG_IMAGE_SIZE bytes):
+//   0-1    magic 'L' 'T'
+//   2      LTC2983_CONFIG_IMAGE_VERSION
+//   3      global configuration register (0x0F0)
+//   4      MUX configuration register (0x0FF)
+//   5      reserved, 0
+//   6-85   channel assignment RAM (0x200-0x24F)
+//   86-87  CRC-16/CCITT of bytes 0-85, most significant byte first
+#define LTC2983_CONFIG_IMAGE_VERSION	1
+#define LTC2983_CONFIG_IMAGE_SIZE		88
+#define CONFIG_IMAGE_CHANNELS_OFFSET	6
+#define CONFIG_IMAGE_CRC_OFFSET			86
+
+// learned thermistor excitation: the fixed current chosen keeps the largest observed
+// resistance, times the margin, below this sensor voltage
+#define THERMISTOR_MAX_EXCITATION_VOLTAGE	1.0f
+#define THERMISTOR_EXCITATION_MARGIN		1.25f
+// Steinhart-Hart coefficients of the 44006 curve, to turn the coldest reading into the
+// largest resistance
+#define THERMISTOR_44006_A	1.032e-3f
+#define THERMISTOR_44006_B	2.387e-4f
+#define THERMISTOR_44006_C	1.580e-7f
+#define EXCITATION_CODE_AUTORANGE			(uint8_t) (THERMISTOR_EXCITATION_CURRENT__AUTORANGE >> THERMISTOR_EXCITATION_CURRENT_LSB)
+#define THERMISTOR_EXCITATION_CURRENT_MASK	((uint32_t) 0xF << THERMISTOR_EXCITATION_CURRENT_LSB)
+
+// nominal conversion time per channel before any learning, in microseconds
+#define NOMINAL_CONVERSION_TIME_US	167000
+// learned conversion times are an exponential average with weight 1/2^CONVERSION_TIME_SHIFT
+#define CONVERSION_TIME_SHIFT		3
+
+// one sample of a CaptureChannel() burst
+struct CaptureSample_t {
+	uint32_t timestamp_us; // micros() when the conversion was seen to finish
+	uint32_t raw_result; // fault byte and 24-bit result, decode with CaptureTemperature()
+};
+
+// time between fused status/result reads while MeasureSweep() waits
+#define SWEEP_POLL_INTERVAL_MS	10
+
+// how blocking methods wait for a conversion
+enum Wait_Mode_t {
+	WAIT_POLL,		// read the status register until done (default)
+	WAIT_LOW_POWER	// idle until InterruptHandler() runs, needs the INTERRUPT pin
+};
+
+// idles the MCU until any interrupt, returns the time spent idle in microseconds
+typedef uint32_t (*IdleHandler_t)(void * context);
+
+// measure priority channels that are in alarm again after this many sweep channels
+#define ALARM_PRIORITY_INTERLEAVE	4
+
+enum Alarm_State_t {
+	ALARM_NONE,
+	ALARM_LOW,
+	ALARM_HIGH
+};
+
+// adaptive sampling: the rate estimate is an exponential average with weight
+// 1/2^ADAPTIVE_RATE_SHIFT, periods halve when moving and grow by 1/4 when quiet
+#define ADAPTIVE_RATE_SHIFT		2
+
+// per-channel rate-of-change tracking for adaptive sampling
+struct AdaptiveChannel_t {
+	bool primed; // false until the channel has a first valid sample
+	int32_t last_value; // 1/1024 degrees
+	uint32_t last_time_ms;
+	uint32_t rate; // average |dT/dt| in 1/1024 degrees per second
+	uint32_t period_ms;
+};
+
+typedef void (*AlarmCallback_t)(uint8_t channel_number, Alarm_State_t state, float temperature);
+
+// result event subscriptions
+#define LTC2983_MAX_SUBSCRIBERS	8
+
+#define EVENT_RESULT	(uint8_t) 0x01 // a valid result was decoded
+#define EVENT_FAULT		(uint8_t) 0x02 // a result carried fault bits or was invalid
+#define EVENT_ALARM		(uint8_t) 0x04 // a channel's alarm state changed
+
+struct LTC2983Event_t {
+	uint8_t type; // one of the EVENT_ bits
+	uint8_t channel_number;
+	uint8_t fault_byte;
+	Alarm_State_t alarm_state;
+	int32_t fixed_temperature; // 1/1024 degrees
+	float temperature;
+	uint32_t timestamp_us; // micros() when the conversion finished (or was first seen to)
+};
+
+typedef void (*EventHandler_t)(void * context, const LTC2983Event_t * event);
+
+struct Subscription_t {
+	LTC2983ChannelSet channels; // empty if the slot is free
+	uint8_t event_mask;
+	EventHandler_t handler;
+	void * context;
+};
+
+// alarm limits in the chip's fixed point format, 1/1024 degrees
+struct Alarm_t {
+	bool enabled;
+	bool priority;
+	Alarm_State_t state;
+	int32_t low;
+	int32_t high;
+	int32_t hysteresis;
+};
+
 
 class LTC2983Manager {
 public:
@@ -69,16 +204,126 @@ public:
 	void InitializeAndConfigure(void);
 	void Sleep(void);
 	void WakeUp(void);
+	bool Sleeping(void) { return _sleeping; }
 	void MeasureAllChannels(void);
+	void MeasureChannels(LTC2983ChannelSet channels);
+	void MeasureChannelsPipelined(LTC2983ChannelSet channels); // overlaps decoding with conversions
 	uint8_t CheckStatusReg(void); //used for debugging SPI
 	uint32_t ReadFullChannelData(uint8_t channel_number); // used to debug channel errors
 	float MeasureChannel(uint8_t channel_number);
+	float ReadChannelResistance(uint8_t channel_number); // raw ohms of the last conversion
+
+	// cached reads: only convert if the stored result is older than max_age_ms, and
+	// share a conversion that is already in flight for the channel
+	float GetChannel(uint8_t channel_number, uint32_t max_age_ms);
+	bool RequestChannel(uint8_t channel_number, uint32_t max_age_ms, float * result); // non-blocking
+	uint32_t ResultAge(uint8_t channel_number); // milliseconds, 0xFFFFFFFF if never measured
 
 	// non-blocking methods
 	void StartMeasurement(uint8_t channel_number);
 	bool FinishedMeasurement(void);
 	float ReadMeasurementResult(uint8_t channel_number);
 	void InterruptHandler(void);
+	bool InterruptPending(void) { return _measurement_finished; } // set by InterruptHandler()
+	void DiscardConversion(void); // forgets a finished conversion or sweep without reading it
+
+	// conversion waits: in WAIT_LOW_POWER the idle handler (WFI by default) is called
+	// until InterruptHandler() has run, or the status register (read after each idle once
+	// the expected conversion time is up) shows it done; a periodic timer interrupt also
+	// ends each idle, and without one a missed interrupt is never noticed
+	void SetWaitMode(Wait_Mode_t mode) { _wait_mode = mode; }
+	Wait_Mode_t WaitMode(void) { return _wait_mode; }
+	void SetIdleHandler(IdleHandler_t handler, void * context); // NULL for the default
+	uint64_t IdleTime(void) { return _idle_time_us; } // microseconds, WAIT_LOW_POWER only
+	void ResetIdleTime(void) { _idle_time_us = 0; }
+
+	// multi-channel conversions, results are fetched with the status in one burst
+	void StartSweep(LTC2983ChannelSet channels);
+	void PrepareSweep(LTC2983ChannelSet channels); // StartSweep() without the start, which is StartMeasurement(0)
+	bool ReadSweepResults(void); // false (only the status byte read) if still converting
+	void MeasureSweep(LTC2983ChannelSet channels); // blocking StartSweep + ReadSweepResults
+	LTC2983ChannelSet SweepChannels(void) { return _sweep_channels; } // of the prepared or running sweep
+	void FinishSweep(uint32_t elapsed_us, uint8_t conversions); // for sweeps run outside MeasureSweep(), see the .cpp
+
+	// lazy results: after a sweep, results stay in chip RAM until asked for, and remain
+	// available until the next conversion is started
+	bool CompleteSweepLazily(void); // non-blocking, false while converting
+	void MeasureSweepLazy(LTC2983ChannelSet channels); // blocking StartSweep + CompleteSweepLazily
+	float GetResult(uint8_t channel_number); // reads and decodes on first access
+	void FetchResults(LTC2983ChannelSet channels); // one burst for all requested channels
+	LTC2983ChannelSet ValidResults(void) { return _lazy_valid; } // channels already decoded this sweep
+
+	// global configuration (register 0x0F0) and its conversion time trade-off
+	void SetGlobalConfiguration(uint8_t rejection, uint8_t temp_unit); // REJECTION__ and TEMP_UNIT__ constants
+	uint8_t GlobalConfiguration(void) { return _global_config; }
+	void SetConversionTime(uint8_t rejection, uint32_t time_us, bool pin = true); // override, e.g. from a timing model
+	bool ConversionTimePinned(uint8_t rejection) { return _conversion_time_pinned & (1 << (rejection & 0x3)); }
+	uint32_t ConversionTime(uint8_t rejection) { return _conversion_time_us[rejection & 0x3]; }
+	uint32_t EstimateSweepDuration(LTC2983ChannelSet channels); // microseconds for the current settings
+
+	// MUX settling delay (register 0x0FF, units of 100 us), applied to the active profile
+	void SetMuxDelay(uint8_t delay);
+	uint8_t MuxDelay(void) { return _mux_delay; }
+	uint8_t TuneMuxDelay(LTC2983ChannelSet channels, uint8_t samples, float max_std_dev); // needs two measurable channels
+
+	// learned fixed thermistor excitation currents (instead of autorange)
+	void StartExcitationCalibration(void);
+	uint8_t FinishExcitationCalibration(void);
+	void ResetExcitation(void); // back to autorange on every channel
+	uint8_t ExcitationCurrent(uint8_t channel_number) { return _therm_excitation[channel_number]; }
+
+	// high-rate capture of a single channel into a caller buffer
+	uint16_t CaptureChannel(uint8_t channel_number, CaptureSample_t * samples, uint16_t count);
+	static float CaptureTemperature(const CaptureSample_t * sample) { return float(raw_result_to_fixed(sample->raw_result)) / 1024; }
+
+	// configuration profiles
+	int8_t DefineProfile(const char * name, const Sensor_Type_t assignments[21]);
+	bool SwitchProfile(const char * name);
+	bool SwitchProfile(uint8_t profile_index);
+	int8_t ActiveProfile(void) { return _active_profile; }
+
+	// configuration images
+	uint16_t SaveConfigImage(uint8_t * buffer, uint16_t buffer_length);
+	bool LoadConfigImage(const uint8_t * buffer, uint16_t length);
+	bool SaveConfigImageToEEPROM(int address);
+	bool LoadConfigImageFromEEPROM(int address);
+
+	// configuration integrity (SEU / latch-up recovery)
+	uint8_t CheckConfiguration(void);
+	void SetIntegrityCheckInterval(uint16_t sweeps);
+	uint32_t ConfigurationRepairs(void) { return _configuration_repairs; }
+
+	// result event subscriptions, handlers run on the completion path as each result
+	// is decoded and must not start conversions themselves
+	int8_t Subscribe(LTC2983ChannelSet channels, uint8_t event_mask, EventHandler_t handler, void * context);
+	void Unsubscribe(int8_t subscription_id);
+
+	// temperature alarms, evaluated as each result is decoded
+	void SetAlarm(uint8_t channel_number, float low, float high, float hysteresis);
+	void ClearAlarm(uint8_t channel_number);
+	void SetAlarmPriority(uint8_t channel_number, bool priority);
+	void SetAlarmCallback(AlarmCallback_t callback) { _alarm_callback = callback; }
+	Alarm_State_t AlarmState(uint8_t channel_number) { return _alarms[channel_number].state; }
+	LTC2983ChannelSet AlarmFlags(void) { return _alarm_flags; } // channels in alarm
+
+	// adaptive sampling, MeasureAllChannels() only converts the channels that are due
+	void EnableAdaptiveSampling(uint32_t min_period_ms, uint32_t max_period_ms, float rate_threshold);
+	void DisableAdaptiveSampling(void) { _adaptive_enabled = false; }
+	bool AdaptiveSamplingEnabled(void) { return _adaptive_enabled; }
+	LTC2983ChannelSet DueChannels(uint32_t now_ms);
+	uint32_t SamplePeriod(uint8_t channel_number) { return _adaptive[channel_number].period_ms; }
+
+	// optional state estimator, fed with every valid result (NULL to detach)
+	void AttachEstimator(LTC2983Estimator * estimator) { _estimator = estimator; }
+
+	// optional multi-rate decimator, fed with every valid result (NULL to detach)
+	void AttachDecimator(LTC2983Decimator * decimator) { _decimator = decimator; }
+
+	// optional history rings, fed with every valid result (NULL to detach)
+	void AttachHistory(LTC2983History * history) { _history = history; }
+
+	// optional streaming quantile estimates, fed with every valid result (NULL to detach)
+	void AttachQuantileSketch(LTC2983QuantileSketch * sketch) { _quantile_sketch = sketch; }
 
     // Depreciate; new resetSpi function assumes port0
     // allow for selection of SPI port
@@ -100,10 +345,37 @@ public:
 private:
 	void Configure();
 
-	// typical sensor methods for Strat2
-	void AssignSenseResistor(uint8_t channel_number); // value: 1000
-	void AssignThermistor(uint8_t channel_number); // must be 44006 10K@25C
-	void AssignRTD(uint8_t channel_number); // must be PT-100
+	// decodes and stores a raw result word, runs everything on the completion path
+	float HandleResult(uint8_t channel_number, uint32_t raw_result, uint32_t completed_ms, uint32_t completed_us);
+	float HandleResult(uint8_t channel_number, uint32_t raw_result) { return HandleResult(channel_number, raw_result, millis(), micros()); } // read right after completion
+	void EvaluateAlarm(uint8_t channel_number, int32_t fixed_temperature);
+	void MeasurePriorityAlarms(void);
+	void EndOfSweep(void);
+	void WaitForConversion(void);
+	uint32_t IdleUntilInterrupt(void);
+	void SetThermistorExcitation(uint8_t channel_number, uint8_t current_code);
+	void ApplyExcitationFallbacks(void);
+	float ThermistorResistance(int32_t fixed_temperature);
+	void CompletionTime(uint32_t * completed_ms, uint32_t * completed_us);
+	bool MuxDelayIsStable(LTC2983ChannelSet channels, uint8_t samples, int64_t max_variance);
+	void LearnConversionTime(uint32_t elapsed_us, uint8_t conversions);
+	void Dispatch(const LTC2983Event_t * event);
+	void UpdateAdaptiveRate(uint8_t channel_number, int32_t fixed_temperature, uint32_t now_ms);
+	bool IsMeasurable(uint8_t channel_number);
+	LTC2983ChannelSet MeasurableChannels(void);
+
+	// channel assignment words for the typical sensors for Strat2
+	uint32_t ChannelWord(Sensor_Type_t assignment, uint8_t channel_number);
+	uint32_t SenseResistorWord(void); // value: 1000
+	uint32_t ThermistorWord(uint8_t channel_number); // must be 44006 10K@25C
+	uint32_t RTDWord(void); // must be PT-100
+
+	// burst-write _channel_words[first_channel..last_channel] to the chip
+	void WriteChannelWords(uint8_t first_channel, uint8_t last_channel);
+	uint8_t PackChannelWords(uint8_t * buffer, uint8_t first_channel, uint8_t last_channel);
+	void UpdateConfigCrc(void);
+	int8_t FindProfile(const char * name);
+	Sensor_Type_t AssignmentFromWord(uint32_t channel_word);
 
 	// board specific settings
 	uint8_t _rtd_sense_channel;
@@ -113,7 +385,73 @@ private:
 	int _reset_pin;
 
 	bool _sleeping;
-	bool _measurement_finished;
+	volatile bool _measurement_finished;
+	volatile uint32_t _finished_ms; // millis() and micros() when InterruptHandler() ran
+	volatile uint32_t _finished_us;
+
+	// conversion waits
+	Wait_Mode_t _wait_mode;
+	IdleHandler_t _idle_handler; // NULL for IdleUntilInterrupt()
+	void * _idle_context;
+	uint64_t _idle_time_us;
+
+	// shadow of the chip's configuration RAM
+	uint32_t _channel_words[21]; // index corresponds to channel, 0 is unused
+	bool _words_loaded; // _channel_words came from an image, Configure() must not rebuild them
+	uint8_t _global_config;
+	uint8_t _mux_delay;
+
+	// per-channel conversion time for each rejection setting, learned or overridden
+	uint32_t _conversion_time_us[4]; // index is the REJECTION__ value (3 is unused)
+	uint8_t _conversion_time_pinned; // bit n set if entry n is not learned
+
+	LTC2983Profile_t _profiles[LTC2983_MAX_PROFILES];
+	int8_t _active_profile; // -1 if channel_assignments[] was configured directly
+
+	// configuration integrity checking
+	uint16_t _config_crc;
+	uint16_t _integrity_check_interval;
+	uint16_t _sweeps_since_check;
+	uint32_t _configuration_repairs;
+
+	// temperature alarms
+	Alarm_t _alarms[21]; // index corresponds to channel, 0 is unused
+	LTC2983ChannelSet _alarm_flags;
+	AlarmCallback_t _alarm_callback;
+
+	// event subscriptions
+	Subscription_t _subscriptions[LTC2983_MAX_SUBSCRIBERS];
+	uint8_t _subscribed_events; // union of all event masks, for a quick reject
+	LTC2983Event_t _event; // event being dispatched for the current result
+
+	// adaptive sampling
+	AdaptiveChannel_t _adaptive[21]; // index corresponds to channel, 0 is unused
+	bool _adaptive_enabled;
+	uint32_t _adaptive_min_period_ms;
+	uint32_t _adaptive_max_period_ms;
+	uint32_t _adaptive_rate_threshold; // 1/1024 degrees per second
+
+	LTC2983ChannelSet _sweep_channels; // measurable channels of the multi-channel conversion
+	LTC2983ChannelSet _lazy_pending; // channels of the last lazy sweep with results in chip RAM
+	LTC2983ChannelSet _lazy_valid; // channels of the last lazy sweep already decoded
+	uint32_t _lazy_completed_ms; // when the last lazy sweep was seen to finish
+	uint32_t _lazy_completed_us;
+
+	// result cache
+	int8_t _in_flight; // channel of a StartMeasurement() not yet read, 0 for a sweep, -1 if none
+	uint32_t _result_time_ms[21]; // millis() of each channel's last result
+	LTC2983ChannelSet _has_result; // channels with at least one result
+
+	// thermistor excitation, current codes are the THERMISTOR_EXCITATION_CURRENT__ values
+	uint8_t _therm_excitation[21]; // index corresponds to channel, 0 is unused
+	int32_t _therm_coldest[21]; // lowest valid result during calibration, 1/1024 degrees
+	bool _excitation_calibrating;
+	LTC2983ChannelSet _excitation_fallbacks; // channels to return to autorange once the chip is idle
+
+	LTC2983Estimator * _estimator;
+	LTC2983Decimator * _decimator;
+	LTC2983History * _history;
+	LTC2983QuantileSketch * _quantile_sketch;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+/*
+ *  LTC2983QuantileSketch.cpp
+ *  Streaming per-channel quantile estimates in constant memory
+ *  October 2026
+ *
+ *  See LTC2983QuantileSketch.h for usage.
+ */
+
+#include "LTC2983QuantileSketch.h"
+
+LTC2983QuantileSketch::LTC2983QuantileSketch(void) {
+	float median = 0.5f;
+	SetQuantiles(&median, 1);
+}
+
+bool LTC2983QuantileSketch::SetQuantiles(const float * quantiles, uint8_t count) {
+	uint8_t i;
+
+	if (count == 0 || count > QUANTILE_SKETCH_MAX_QUANTILES) return false;
+	for (i = 0; i < count; i++) {
+		if (!(quantiles[i] > 0.0f && quantiles[i] < 1.0f)) return false;
+	}
+
+	for (i = 0; i < count; i++) {
+		_p[i] = quantiles[i];
+	}
+	_quantile_count = count;
+
+	ResetAll();
+	return true;
+}
+
+void LTC2983QuantileSketch::Push(uint8_t channel_number, int32_t fixed_temperature) {
+	float value = float(fixed_temperature) / 1024;
+	uint8_t q, i;
+
+	if (channel_number < 1 || channel_number > 20) return;
+
+	ChannelSketch_t * sketch = &_channels[channel_number];
+
+	// the first five samples are kept sorted and become the initial markers
+	if (sketch->count < 5) {
+		for (q = 0; q < _quantile_count; q++) {
+			float * height = sketch->markers[q].height;
+			for (i = sketch->count; i > 0 && height[i - 1] > value; i--) {
+				height[i] = height[i - 1];
+			}
+			height[i] = value;
+
+			if (sketch->count == 4) {
+				for (i = 0; i < 5; i++) {
+					sketch->markers[q].position[i] = i;
+				}
+			}
+		}
+
+		sketch->count++;
+		return;
+	}
+
+	sketch->count++;
+	for (q = 0; q < _quantile_count; q++) {
+		Update(&sketch->markers[q], _p[q], sketch->count, value);
+	}
+}
+
+bool LTC2983QuantileSketch::Snapshot(uint8_t channel_number, QuantileSnapshot_t * snapshot, bool reset) {
+	uint8_t q;
+
+	if (channel_number < 1 || channel_number > 20) return false;
+
+	ChannelSketch_t * sketch = &_channels[channel_number];
+	if (sketch->count == 0) return false;
+
+	snapshot->count = sketch->count;
+	for (q = 0; q < QUANTILE_SKETCH_MAX_QUANTILES; q++) {
+		snapshot->quantiles[q] = 0.0f;
+	}
+
+	// at five samples the markers are still the sorted samples themselves
+	if (sketch->count <= 5) {
+		const float * sorted = sketch->markers[0].height;
+		snapshot->min = sorted[0];
+		snapshot->max = sorted[sketch->count - 1];
+		for (q = 0; q < _quantile_count; q++) {
+			snapshot->quantiles[q] = SmallSampleQuantile(sorted, sketch->count, _p[q]);
+		}
+	} else {
+		// every quantile's outer markers are the same minimum and maximum
+		snapshot->min = sketch->markers[0].height[0];
+		snapshot->max = sketch->markers[0].height[4];
+		for (q = 0; q < _quantile_count; q++) {
+			snapshot->quantiles[q] = sketch->markers[q].height[2];
+		}
+	}
+
+	if (reset) Reset(channel_number);
+	return true;
+}
+
+void LTC2983QuantileSketch::Reset(uint8_t channel_number) {
+	if (channel_number > 20) return;
+
+	_channels[channel_number].count = 0;
+}
+
+void LTC2983QuantileSketch::ResetAll(void) {
+	uint8_t channel;
+
+	for (channel = 0; channel < 21; channel++) {
+		Reset(channel);
+	}
+}
+
+// Private methods ------------------------------------------------------------
+// One P-squared step for a sample that is already counted in count. The desired marker
+// positions are recomputed from count rather than accumulated, so they stay exact.
+void LTC2983QuantileSketch::Update(Markers_t * markers, float p, uint32_t count, float value) {
+	float * height = markers->height;
+	uint32_t * position = markers->position;
+	float span = (float) (count - 1);
+	float desired[5] = {0.0f, span * p / 2, span * p, span * (1.0f + p) / 2, span};
+	float offset, candidate, below, here, above;
+	int8_t step;
+	uint8_t cell, i;
+
+	// find the cell the sample falls in, stretching the extremes if needed
+	if (value < height[0]) {
+		height[0] = value;
+		cell = 0;
+	} else if (value >= height[4]) {
+		height[4] = value;
+		cell = 3;
+	} else {
+		for (cell = 0; cell < 3 && value >= height[cell + 1]; cell++) { }
+	}
+
+	for (i = cell + 1; i < 5; i++) {
+		position[i]++;
+	}
+
+	// move each middle marker at most one rank towards its desired position
+	for (i = 1; i < 4; i++) {
+		offset = desired[i] - (float) position[i];
+		if (!((offset >= 1.0f && position[i + 1] - position[i] > 1) || (offset <= -1.0f && position[i] - position[i - 1] > 1))) continue;
+
+		step = (offset > 0.0f) ? 1 : -1;
+		below = (float) position[i - 1];
+		here = (float) position[i];
+		above = (float) position[i + 1];
+
+		candidate = height[i] + step / (above - below) *
+			((here - below + step) * (height[i + 1] - height[i]) / (above - here) +
+			 (above - here - step) * (height[i] - height[i - 1]) / (here - below));
+
+		if (height[i - 1] < candidate && candidate < height[i + 1]) {
+			height[i] = candidate;
+		} else {
+			// the parabola would break the ordering, fall back to linear
+			height[i] += step * (height[i + step] - height[i]) / ((float) position[i + step] - here);
+		}
+		position[i] += step;
+	}
+}
+
+// linear interpolation between the closest ranks of up to five sorted samples
+float LTC2983QuantileSketch::SmallSampleQuantile(const float * sorted, uint32_t count, float p) {
+	float rank = p * (count - 1);
+	uint32_t index = (uint32_t) rank;
+
+	if (index + 1 >= count) return sorted[count - 1];
+	return sorted[index] + (rank - index) * (sorted[index + 1] - sorted[index]);
+}
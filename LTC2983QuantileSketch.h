@@ -0,0 +1,78 @@
+/*
+ *  LTC2983QuantileSketch.h
+ *  Streaming per-channel quantile estimates in constant memory
+ *  October 2026
+ *
+ *  Estimates a few fixed quantiles (e.g. the 5th, 50th and 95th percentile) of each
+ *  channel's results over an arbitrarily long window without storing the samples,
+ *  using the P-squared algorithm (Jain and Chlamtac, 1985). Each quantile of each
+ *  channel keeps five markers, the minimum, the maximum and three around the quantile,
+ *  whose heights are adjusted with piecewise-parabolic interpolation as samples arrive,
+ *  so every update is constant time and the estimates can be read at any moment.
+ *
+ *  To use:
+ *    0) Instantiate an object of the class and choose the quantiles with SetQuantiles()
+ *    1) Attach it with LTC2983Manager::AttachQuantileSketch(), or feed it with Push()
+ *    2) Read a channel with Snapshot(), optionally resetting it for the next window
+ *
+ *  Up to five samples per channel the quantiles are interpolated from the samples
+ *  themselves, which is exact.
+ */
+
+#ifndef LTC2983QUANTILESKETCH_H
+#define LTC2983QUANTILESKETCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef QUANTILE_SKETCH_MAX_QUANTILES
+#define QUANTILE_SKETCH_MAX_QUANTILES	3
+#endif
+
+struct QuantileSnapshot_t {
+	uint32_t count; // samples since the last reset
+	float min;
+	float max;
+	float quantiles[QUANTILE_SKETCH_MAX_QUANTILES]; // in the order given to SetQuantiles()
+};
+
+class LTC2983QuantileSketch {
+public:
+	LTC2983QuantileSketch(void); // median only until SetQuantiles() is called
+	~LTC2983QuantileSketch(void) { }; // nothing to destruct
+
+	// configuration, each quantile strictly between 0 and 1; resets every channel
+	bool SetQuantiles(const float * quantiles, uint8_t count);
+
+	// input, temperature in 1/1024 degrees
+	void Push(uint8_t channel_number, int32_t fixed_temperature);
+
+	// output, false if the channel has no samples
+	bool Snapshot(uint8_t channel_number, QuantileSnapshot_t * snapshot, bool reset = false);
+	uint32_t Count(uint8_t channel_number) { return (channel_number <= 20) ? _channels[channel_number].count : 0; }
+
+	void Reset(uint8_t channel_number);
+	void ResetAll(void);
+
+private:
+	// five P-squared markers, positions are 0-based sample ranks
+	struct Markers_t {
+		float height[5];
+		uint32_t position[5];
+	};
+
+	struct ChannelSketch_t {
+		uint32_t count;
+		Markers_t markers[QUANTILE_SKETCH_MAX_QUANTILES];
+	};
+
+	void Update(Markers_t * markers, float p, uint32_t count, float value);
+	float SmallSampleQuantile(const float * sorted, uint32_t count, float p);
+
+	float _p[QUANTILE_SKETCH_MAX_QUANTILES];
+	uint8_t _quantile_count;
+
+	ChannelSketch_t _channels[21]; // index corresponds to channel, 0 is unused
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ *  LTC2983RTOS.cpp
+ *  FreeRTOS adapter for sharing an LTC2983Manager between tasks
+ *  October 2026
+ *
+ *  See LTC2983RTOS.h for usage.
+ */
+
+#include "LTC2983RTOS.h"
+
+#ifdef LTC2983_USE_FREERTOS
+
+LTC2983RtosManager::LTC2983RtosManager(LTC2983Manager * manager, bool use_interrupt) {
+	_manager = manager;
+	_use_interrupt = use_interrupt;
+	_waiting_task = NULL;
+	_abandoned = false;
+
+	// static creation needs no heap and is allowed before the scheduler starts
+	_mutex = xSemaphoreCreateMutexStatic(&_mutex_buffer);
+}
+
+LTC2983RtosManager::~LTC2983RtosManager(void) {
+	vSemaphoreDelete(_mutex);
+}
+
+bool LTC2983RtosManager::MeasureChannel(uint8_t channel_number, float * result, TickType_t timeout) {
+	TimeOut_t start;
+	bool finished;
+
+	vTaskSetTimeOutState(&start);
+	if (!LockIdle(&start, &timeout)) return false;
+
+	// like LTC2983Manager::MeasureChannel(), channels without a temperature are not converted
+	Sensor_Type_t assignment = (channel_number >= 1 && channel_number <= 20) ? _manager->channel_assignments[channel_number] : UNUSED_CHANNEL;
+	if (assignment != THERMISTOR_44006 && assignment != RTD_PT_100) {
+		*result = TEMPERATURE_ERROR;
+		Unlock();
+		return true;
+	}
+
+	if (_manager->Sleeping()) _manager->WakeUp();
+
+	// the waiting task is published and stale notifications cleared before the start
+	// command, so an interrupt that arrives immediately is not lost
+	_waiting_task = xTaskGetCurrentTaskHandle();
+	ulTaskNotifyTake(pdTRUE, 0);
+	_manager->StartMeasurement(channel_number);
+
+	finished = WaitForConversion(false, &start, &timeout);
+	_waiting_task = NULL;
+	if (finished) {
+		*result = _manager->ReadMeasurementResult(channel_number);
+	} else {
+		_abandoned = true;
+	}
+
+	Unlock();
+	return finished;
+}
+
+bool LTC2983RtosManager::MeasureSweep(LTC2983ChannelSet channels, TickType_t timeout) {
+	TimeOut_t start;
+	bool finished;
+
+	vTaskSetTimeOutState(&start);
+	if (!LockIdle(&start, &timeout)) return false;
+
+	finished = Sweep(channels, &start, &timeout);
+
+	Unlock();
+	return finished;
+}
+
+// the due channels are chosen under the mutex, so no other task's results change them
+bool LTC2983RtosManager::MeasureAllChannels(TickType_t timeout) {
+	TimeOut_t start;
+	bool finished;
+
+	vTaskSetTimeOutState(&start);
+	if (!LockIdle(&start, &timeout)) return false;
+
+	if (_manager->AdaptiveSamplingEnabled()) {
+		finished = Sweep(_manager->DueChannels(millis()), &start, &timeout);
+	} else {
+		finished = Sweep(LTC2983ChannelSet::All(), &start, &timeout);
+	}
+
+	Unlock();
+	return finished;
+}
+
+bool LTC2983RtosManager::Lock(TickType_t timeout) {
+	TimeOut_t start;
+
+	vTaskSetTimeOutState(&start);
+	return LockIdle(&start, &timeout);
+}
+
+void LTC2983RtosManager::InterruptFromISR(void) {
+	BaseType_t higher_priority_woken = pdFALSE;
+	TaskHandle_t task = _waiting_task;
+
+	_manager->InterruptHandler();
+	if (task != NULL) vTaskNotifyGiveFromISR(task, &higher_priority_woken);
+
+	portYIELD_FROM_ISR(higher_priority_woken);
+}
+
+// Takes the mutex, then lets a conversion abandoned by an earlier timeout finish and
+// discards it, so the caller starts on an idle chip with no stale completion pending.
+// Gives the mutex back and returns false if the chip is still busy at the timeout.
+bool LTC2983RtosManager::LockIdle(TimeOut_t * start, TickType_t * timeout) {
+	if (xSemaphoreTake(_mutex, *timeout) != pdTRUE) return false;
+	if (!_abandoned) return true;
+
+	while (!_manager->FinishedMeasurement()) {
+		if (xTaskCheckForTimeOut(start, timeout) == pdTRUE) {
+			Unlock();
+			return false;
+		}
+		vTaskDelay(*timeout < LTC2983_RTOS_POLL_TICKS ? *timeout : LTC2983_RTOS_POLL_TICKS);
+	}
+
+	_manager->DiscardConversion();
+	ulTaskNotifyTake(pdTRUE, 0);
+	_abandoned = false;
+	return true;
+}
+
+// Runs a sweep with the mutex already held. StartSweep() wakes the chip if needed, and a
+// finished sweep gets the manager's end-of-sweep work like LTC2983Manager::MeasureSweep().
+bool LTC2983RtosManager::Sweep(LTC2983ChannelSet channels, TimeOut_t * start, TickType_t * timeout) {
+	uint32_t start_us = micros();
+	uint8_t conversions;
+	bool finished;
+
+	_waiting_task = xTaskGetCurrentTaskHandle();
+	ulTaskNotifyTake(pdTRUE, 0);
+	_manager->StartSweep(channels);
+	conversions = _manager->SweepChannels().Count();
+
+	finished = WaitForConversion(true, start, timeout);
+	_waiting_task = NULL;
+	if (finished) {
+		_manager->FinishSweep(micros() - start_us, conversions);
+	} else {
+		_abandoned = true;
+	}
+
+	return finished;
+}
+
+// Blocks until the conversion finishes or the remaining timeout runs out. For sweeps
+// the results are read too: without the interrupt pin every poll is the manager's
+// fused status/result burst, so the final poll delivers the data.
+bool LTC2983RtosManager::WaitForConversion(bool sweep, TimeOut_t * start, TickType_t * timeout) {
+	for (;;) {
+		if (_use_interrupt) {
+			if (_manager->InterruptPending()) return sweep ? _manager->ReadSweepResults() : true;
+		} else {
+			if (sweep ? _manager->ReadSweepResults() : _manager->FinishedMeasurement()) return true;
+		}
+
+		if (xTaskCheckForTimeOut(start, timeout) == pdTRUE) return false;
+
+		if (_use_interrupt) {
+			ulTaskNotifyTake(pdTRUE, *timeout);
+		} else {
+			vTaskDelay(*timeout < LTC2983_RTOS_POLL_TICKS ? *timeout : LTC2983_RTOS_POLL_TICKS);
+		}
+	}
+}
+
+#endif // LTC2983_USE_FREERTOS
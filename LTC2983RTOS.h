@@ -0,0 +1,85 @@
+/*
+ *  LTC2983RTOS.h
+ *  FreeRTOS adapter for sharing an LTC2983Manager between tasks
+ *  October 2026
+ *
+ *  The blocking LTC2983Manager methods poll the chip until a conversion finishes,
+ *  which keeps the calling task running for the whole conversion. This adapter uses
+ *  the non-blocking methods instead and blocks the calling task on a direct-to-task
+ *  notification, so lower-priority tasks run while the chip converts.
+ *
+ *  To use:
+ *    0) Define LTC2983_USE_FREERTOS for the build (FreeRTOSConfig.h must enable
+ *       configSUPPORT_STATIC_ALLOCATION and configUSE_MUTEXES)
+ *    1) Instantiate one LTC2983RtosManager per LTC2983Manager, and initialize the
+ *       manager as usual before the tasks start
+ *    2) If the chip's INTERRUPT pin is wired, call InterruptFromISR() from its
+ *       interrupt service routine (it calls LTC2983Manager::InterruptHandler() itself)
+ *    3) Measure from any task with MeasureChannel(), MeasureSweep() or
+ *       MeasureAllChannels(); other manager methods are called between Lock() and
+ *       Unlock() through Manager()
+ *
+ *  Every method takes a timeout in ticks that covers both waiting for the mutex and
+ *  waiting for the conversion, and returns false if it runs out. A conversion that
+ *  times out is left running on the chip and its result is discarded: the next Lock()
+ *  or measurement waits (within its own timeout) for the chip to finish before
+ *  anything else reaches it.
+ *
+ *  Without the interrupt pin, completion is detected by reading the status register
+ *  once every LTC2983_RTOS_POLL_TICKS, sleeping in between.
+ *
+ *  Note: only the FreeRTOS kernel API is used (no port-specific calls), but like the
+ *        manager itself this file needs the Arduino core (SPI, millis(), micros())
+ */
+
+#ifndef LTC2983RTOS_H
+#define LTC2983RTOS_H
+
+#ifdef LTC2983_USE_FREERTOS
+
+#include "LTC2983Manager.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#ifndef LTC2983_RTOS_POLL_TICKS
+#define LTC2983_RTOS_POLL_TICKS	1 // status register poll interval without the interrupt pin
+#endif
+
+class LTC2983RtosManager {
+public:
+	LTC2983RtosManager(LTC2983Manager * manager, bool use_interrupt = true);
+	~LTC2983RtosManager(void);
+
+	// serialized measurements, each returns false on timeout
+	bool MeasureChannel(uint8_t channel_number, float * result, TickType_t timeout);
+	bool MeasureSweep(LTC2983ChannelSet channels, TickType_t timeout);
+	bool MeasureAllChannels(TickType_t timeout); // due channels if adaptive sampling is on
+
+	// exclusive access for all other manager methods
+	bool Lock(TickType_t timeout);
+	void Unlock(void) { xSemaphoreGive(_mutex); }
+	LTC2983Manager * Manager(void) { return _manager; }
+
+	// call from the INTERRUPT pin's interrupt service routine
+	void InterruptFromISR(void);
+
+private:
+	bool LockIdle(TimeOut_t * start, TickType_t * timeout);
+	bool Sweep(LTC2983ChannelSet channels, TimeOut_t * start, TickType_t * timeout); // mutex held
+	bool WaitForConversion(bool sweep, TimeOut_t * start, TickType_t * timeout);
+
+	LTC2983Manager * _manager;
+	bool _use_interrupt;
+
+	StaticSemaphore_t _mutex_buffer;
+	SemaphoreHandle_t _mutex;
+
+	// task blocked on the current conversion, NULL if none (read from the ISR)
+	TaskHandle_t volatile _waiting_task;
+	bool _abandoned; // a timed out conversion may still be running on the chip
+};
+
+#endif // LTC2983_USE_FREERTOS
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ *  LTC2983SampleMerger.cpp
+ *  Time-ordered merge of the result streams of several LTC2983 chips
+ *  October 2026
+ *
+ *  See LTC2983SampleMerger.h for usage.
+ */
+
+#include "LTC2983SampleMerger.h"
+
+LTC2983SampleMerger::LTC2983SampleMerger(void) {
+	_chip_count = 0;
+	_dropped = 0;
+	_heap_size = 0;
+
+	uint8_t chip;
+	for (chip = 0; chip < LTC2983_MERGER_MAX_CHIPS; chip++) {
+		_queues[chip].head = 0;
+		_queues[chip].count = 0;
+		_sources[chip].merger = this;
+		_sources[chip].manager = NULL;
+		_sources[chip].subscription = -1;
+		_sources[chip].chip = chip;
+	}
+}
+
+LTC2983SampleMerger::~LTC2983SampleMerger(void) {
+	uint8_t chip;
+
+	for (chip = 0; chip < _chip_count; chip++) {
+		if (_sources[chip].manager != NULL) _sources[chip].manager->Unsubscribe(_sources[chip].subscription);
+	}
+}
+
+int8_t LTC2983SampleMerger::AddChip(LTC2983Manager * manager) {
+	if (_chip_count >= LTC2983_MERGER_MAX_CHIPS) return -1;
+
+	Source_t * source = &_sources[_chip_count];
+	source->subscription = manager->Subscribe(LTC2983ChannelSet::All(), EVENT_RESULT | EVENT_FAULT, EventHandler, source);
+	if (source->subscription < 0) return -1;
+
+	source->manager = manager;
+	return _chip_count++;
+}
+
+int8_t LTC2983SampleMerger::AddSource(void) {
+	if (_chip_count >= LTC2983_MERGER_MAX_CHIPS) return -1;
+
+	return _chip_count++;
+}
+
+// samples of one chip must be pushed in time order
+bool LTC2983SampleMerger::Push(uint8_t chip, uint8_t channel_number, int32_t fixed_temperature, uint8_t fault_byte, uint32_t timestamp_us) {
+	if (chip >= _chip_count) return false;
+
+	SampleQueue_t * queue = &_queues[chip];
+	if (queue->count >= LTC2983_MERGER_QUEUE_LENGTH) {
+		_dropped++;
+		return false;
+	}
+
+	MergedSample_t * sample = &queue->samples[(queue->head + queue->count) % LTC2983_MERGER_QUEUE_LENGTH];
+	sample->timestamp_us = timestamp_us;
+	sample->fixed_temperature = fixed_temperature;
+	sample->chip = chip;
+	sample->channel_number = channel_number;
+	sample->fault_byte = fault_byte;
+	queue->count++;
+
+	return true;
+}
+
+// The heap is rebuilt from the queue heads on every call (at most
+// LTC2983_MERGER_MAX_CHIPS entries), then each emitted sample costs one sift-down.
+uint16_t LTC2983SampleMerger::Drain(MergedSample_t * out, uint16_t max_samples, bool flush) {
+	uint16_t written = 0;
+	uint8_t chip, i;
+	SampleQueue_t * queue;
+
+	_heap_size = 0;
+	for (chip = 0; chip < _chip_count; chip++) {
+		if (_queues[chip].count == 0) {
+			if (!flush) return 0; // this chip could still produce the oldest sample
+			continue;
+		}
+		_heap[_heap_size++] = chip;
+	}
+
+	for (i = _heap_size / 2; i > 0; i--) {
+		SiftDown(i - 1);
+	}
+
+	while (written < max_samples && _heap_size > 0) {
+		chip = _heap[0];
+		queue = &_queues[chip];
+
+		out[written++] = queue->samples[queue->head];
+		queue->head = (queue->head + 1) % LTC2983_MERGER_QUEUE_LENGTH;
+		queue->count--;
+
+		if (queue->count == 0) {
+			if (!flush) break;
+			_heap[0] = _heap[--_heap_size];
+		}
+		SiftDown(0);
+	}
+
+	return written;
+}
+
+uint16_t LTC2983SampleMerger::Queued(void) {
+	uint16_t queued = 0;
+	uint8_t chip;
+
+	for (chip = 0; chip < _chip_count; chip++) {
+		queued += _queues[chip].count;
+	}
+
+	return queued;
+}
+
+// Private methods ------------------------------------------------------------
+void LTC2983SampleMerger::EventHandler(void * context, const LTC2983Event_t * event) {
+	Source_t * source = (Source_t *) context;
+
+	source->merger->Push(source->chip, event->channel_number, event->fixed_temperature, event->fault_byte, event->timestamp_us);
+}
+
+// compares head timestamps modulo 2^32, ties go to the lower chip index
+bool LTC2983SampleMerger::Earlier(uint8_t chip_a, uint8_t chip_b) {
+	int32_t difference = (int32_t) (_queues[chip_a].samples[_queues[chip_a].head].timestamp_us - _queues[chip_b].samples[_queues[chip_b].head].timestamp_us);
+
+	return difference < 0 || (difference == 0 && chip_a < chip_b);
+}
+
+void LTC2983SampleMerger::SiftDown(uint8_t position) {
+	uint8_t child, swap;
+
+	for (;;) {
+		child = 2 * position + 1;
+		if (child >= _heap_size) return;
+		if (child + 1 < _heap_size && Earlier(_heap[child + 1], _heap[child])) child++;
+		if (!Earlier(_heap[child], _heap[position])) return;
+
+		swap = _heap[position];
+		_heap[position] = _heap[child];
+		_heap[child] = swap;
+		position = child;
+	}
+}
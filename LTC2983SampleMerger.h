@@ -0,0 +1,96 @@
+/*
+ *  LTC2983SampleMerger.h
+ *  Time-ordered merge of the result streams of several LTC2983 chips
+ *  October 2026
+ *
+ *  Every manager delivers its results in time order, but results from different chips
+ *  interleave arbitrarily. The merger keeps a bounded queue of timestamped samples per
+ *  chip and drains them as one stream ordered by timestamp and tagged with (chip,
+ *  channel), using a k-way merge over a min-heap of the queue heads.
+ *
+ *  To use:
+ *    0) Instantiate an object of the class
+ *    1) AddChip() each manager; this subscribes to its result and fault events (or
+ *       feed samples with Push() from another source)
+ *    2) Periodically Drain() into a caller buffer
+ *
+ *  Without flush, Drain() only emits a sample while every chip has a queued sample, so
+ *  nothing arriving later can be older than what was emitted; a chip that stops
+ *  producing therefore holds the stream back. With flush, everything queued is emitted
+ *  (for example when all managers run in the calling thread, or at shutdown).
+ *
+ *  A sample pushed into a full queue is dropped and counted in Dropped().
+ *
+ *  Note: timestamps are micros() and compared modulo 2^32, so samples in the merger
+ *        at one time must span less than ~35 minutes.
+ */
+
+#ifndef LTC2983SAMPLEMERGER_H
+#define LTC2983SAMPLEMERGER_H
+
+#include "LTC2983Manager.h"
+
+#ifndef LTC2983_MERGER_MAX_CHIPS
+#define LTC2983_MERGER_MAX_CHIPS	8
+#endif
+
+#ifndef LTC2983_MERGER_QUEUE_LENGTH
+#define LTC2983_MERGER_QUEUE_LENGTH	32 // samples per chip, at most 255
+#endif
+
+struct MergedSample_t {
+	uint32_t timestamp_us; // micros() when the conversion finished (or was first seen to)
+	int32_t fixed_temperature; // 1/1024 degrees
+	uint8_t chip; // index returned by AddChip()
+	uint8_t channel_number;
+	uint8_t fault_byte;
+};
+
+class LTC2983SampleMerger {
+public:
+	LTC2983SampleMerger(void);
+	~LTC2983SampleMerger(void);
+
+	// sources, both return the chip index or -1 if LTC2983_MERGER_MAX_CHIPS are in use
+	int8_t AddChip(LTC2983Manager * manager); // subscribes to EVENT_RESULT and EVENT_FAULT
+	int8_t AddSource(void); // for samples pushed by the caller
+
+	bool Push(uint8_t chip, uint8_t channel_number, int32_t fixed_temperature, uint8_t fault_byte, uint32_t timestamp_us);
+
+	// merged output, returns the number of samples written to out
+	uint16_t Drain(MergedSample_t * out, uint16_t max_samples, bool flush);
+
+	uint16_t Queued(void); // samples in all queues
+	uint32_t Dropped(void) { return _dropped; }
+
+private:
+	struct SampleQueue_t {
+		MergedSample_t samples[LTC2983_MERGER_QUEUE_LENGTH];
+		uint8_t head; // oldest sample
+		uint8_t count;
+	};
+
+	// context of each chip's subscription
+	struct Source_t {
+		LTC2983SampleMerger * merger;
+		LTC2983Manager * manager; // NULL for AddSource()
+		int8_t subscription;
+		uint8_t chip;
+	};
+
+	static void EventHandler(void * context, const LTC2983Event_t * event);
+
+	bool Earlier(uint8_t chip_a, uint8_t chip_b);
+	void SiftDown(uint8_t position);
+
+	SampleQueue_t _queues[LTC2983_MERGER_MAX_CHIPS];
+	Source_t _sources[LTC2983_MERGER_MAX_CHIPS];
+	uint8_t _chip_count;
+	uint32_t _dropped;
+
+	// min-heap of chip indices keyed by the timestamp of their oldest queued sample
+	uint8_t _heap[LTC2983_MERGER_MAX_CHIPS];
+	uint8_t _heap_size;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ *  LTC2983SyncGroup.cpp
+ *  Time-synchronized sweeps across several LTC2983 chips
+ *  October 2026
+ *
+ *  See LTC2983SyncGroup.h for usage.
+ */
+
+#include "LTC2983SyncGroup.h"
+
+LTC2983SyncGroup::LTC2983SyncGroup(void) {
+	_chip_count = 0;
+	_armed = false;
+	_triggered = false;
+	_trigger_us = 0;
+	_learn_timing = false;
+
+	uint8_t i;
+	for (i = 0; i < LTC2983_MAX_SYNC_CHIPS; i++) {
+		_chips[i] = NULL;
+		_finished[i] = false;
+		_conversions[i] = 0;
+		_start_us[i] = 0;
+	}
+}
+
+bool LTC2983SyncGroup::AddChip(LTC2983Manager * manager) {
+	if (_chip_count >= LTC2983_MAX_SYNC_CHIPS) return false;
+
+	_chips[_chip_count++] = manager;
+	return true;
+}
+
+// Everything except the start command is done here, so the trigger has the least
+// possible work between chips
+void LTC2983SyncGroup::Arm(LTC2983ChannelSet channels) {
+	uint8_t i;
+
+	for (i = 0; i < _chip_count; i++) {
+		_chips[i]->PrepareSweep(channels);
+		_conversions[i] = _chips[i]->SweepChannels().Count();
+		_finished[i] = false;
+	}
+
+	_learn_timing = false;
+	_triggered = false;
+	_armed = true;
+}
+
+void LTC2983SyncGroup::Trigger(void) {
+	uint8_t i;
+
+	if (!_armed || _triggered) return;
+
+	_trigger_us = micros();
+	for (i = 0; i < _chip_count; i++) {
+		_start_us[i] = micros();
+		if (_conversions[i] > 0) _chips[i]->StartMeasurement(0); // nothing to sweep otherwise
+	}
+
+	_triggered = true;
+}
+
+// Reads each chip's results as soon as it is done, chips that are still converting are
+// polled again next time. Returns false while armed and waiting for the trigger.
+bool LTC2983SyncGroup::Poll(void) {
+	bool finished = true;
+	uint8_t i;
+
+	if (!_armed) return true;
+	if (!_triggered) return false;
+
+	for (i = 0; i < _chip_count; i++) {
+		if (_finished[i]) continue;
+
+		_finished[i] = _chips[i]->ReadSweepResults();
+		if (_finished[i]) {
+			// Measure() polls every SWEEP_POLL_INTERVAL_MS, so completion was half of that earlier on average
+			_chips[i]->FinishSweep(_learn_timing ? micros() - _start_us[i] - (uint32_t) SWEEP_POLL_INTERVAL_MS * 500 : 0, _conversions[i]);
+		} else {
+			finished = false;
+		}
+	}
+
+	if (finished) {
+		_armed = false;
+		_triggered = false;
+	}
+
+	return finished;
+}
+
+void LTC2983SyncGroup::Measure(LTC2983ChannelSet channels) {
+	Arm(channels);
+	_learn_timing = true;
+	Trigger();
+
+	while (!Poll()) {
+		delay(SWEEP_POLL_INTERVAL_MS);
+	}
+}
+
+uint32_t LTC2983SyncGroup::MaxSkew(void) {
+	uint32_t max_skew = 0;
+	uint8_t i;
+
+	for (i = 0; i < _chip_count; i++) {
+		if (Skew(i) > max_skew) max_skew = Skew(i);
+	}
+
+	return max_skew;
+}
@@ -0,0 +1,72 @@
+/*
+ *  LTC2983SyncGroup.h
+ *  Time-synchronized sweeps across several LTC2983 chips
+ *  October 2026
+ *
+ *  Each LTC2983Manager starts its conversions whenever its own methods are called, so
+ *  sweeps on different chips drift apart in time. A sync group starts a multi-channel
+ *  sweep on every member chip from one trigger, with the chips' start commands issued
+ *  back to back, and records when each chip actually started.
+ *
+ *  To use:
+ *    0) Instantiate a group and AddChip() each initialized manager
+ *    1) Arm() the group with the channels to sweep; this writes every chip's channel
+ *       mask register ahead of time, so that starting a chip is one command byte
+ *    2) Call Trigger() at the common instant, e.g. from a timer or PPS edge interrupt
+ *    3) Call Poll() until it returns true; results are then in each manager's
+ *       channel_temperatures[] and went through its normal result path, and each
+ *       manager has done its end-of-sweep work (excitation fallbacks, integrity check)
+ *
+ *  Measure() does all of this for a software trigger and waits for the results. Since
+ *  it polls at a known interval, it also feeds each chip's conversion time learning.
+ *
+ *  Skew(i) is the delay from the trigger to chip i's start command in microseconds,
+ *  bounded by the SPI time of one command byte per chip ahead of it in the group.
+ *
+ *  Note: if Trigger() runs in an interrupt, no other SPI traffic may be in progress on
+ *        the bus when it fires. Arm() before the trigger and Poll() only after it.
+ */
+
+#ifndef LTC2983SYNCGROUP_H
+#define LTC2983SYNCGROUP_H
+
+#include "LTC2983Manager.h"
+
+#ifndef LTC2983_MAX_SYNC_CHIPS
+#define LTC2983_MAX_SYNC_CHIPS	8
+#endif
+
+class LTC2983SyncGroup {
+public:
+	LTC2983SyncGroup(void);
+	~LTC2983SyncGroup(void) { }; // nothing to destruct
+
+	bool AddChip(LTC2983Manager * manager); // false if the group is full
+	uint8_t Chips(void) { return _chip_count; }
+
+	// synchronized sweep
+	void Arm(LTC2983ChannelSet channels);
+	void Trigger(void); // interrupt safe once armed
+	bool Poll(void); // true once every chip's results are read and its sweep finished
+	void Measure(LTC2983ChannelSet channels); // blocking Arm + Trigger + Poll
+
+	// timing of the last trigger, in micros()
+	uint32_t TriggerTime(void) { return _trigger_us; }
+	uint32_t Skew(uint8_t chip_index) { return (chip_index < _chip_count) ? _start_us[chip_index] - _trigger_us : 0; }
+	uint32_t MaxSkew(void);
+
+private:
+	LTC2983Manager * _chips[LTC2983_MAX_SYNC_CHIPS];
+	uint8_t _chip_count;
+
+	volatile bool _armed;
+	volatile bool _triggered;
+	bool _finished[LTC2983_MAX_SYNC_CHIPS];
+	uint8_t _conversions[LTC2983_MAX_SYNC_CHIPS]; // channels in each chip's sweep
+	bool _learn_timing; // only Measure() polls often enough to time the conversions
+
+	uint32_t _trigger_us;
+	uint32_t _start_us[LTC2983_MAX_SYNC_CHIPS]; // micros() just before each start command
+};
+
+#endif
@@ -315,6 +315,9 @@ ongoing work.
 #define VOUT_CH_BASE                     (uint16_t) 0x0060
 #define READ_CH_BASE                     (uint16_t) 0x0010
 #define CONVERSION_RESULT_MEMORY_BASE    (uint16_t) 0x0010
+#define GLOBAL_CONFIGURATION_REGISTER    (uint16_t) 0x00F0
+#define MUX_CONFIGURATION_REGISTER       (uint16_t) 0x00FF
+#define MULTIPLE_CHANNEL_MASK_REGISTER   (uint16_t) 0x00F4
 //**********************************************************************************************************
 // -- MISC CONSTANTS --
 //**********************************************************************************************************
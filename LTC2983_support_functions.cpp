@@ -149,6 +149,52 @@ float get_result(uint8_t chip_select, uint8_t channel_number, uint8_t channel_ou
     return temperature;
 }
 
+// Full 32-bit result word: fault byte in the 8 MSB's, conversion result in the 24 LSB's
+uint32_t get_raw_result(uint8_t chip_select, uint8_t channel_number)
+{
+    uint16_t start_address = get_start_address(CONVERSION_RESULT_MEMORY_BASE, channel_number);
+    return transfer_four_bytes(chip_select, READ_FROM_RAM, start_address, 0);
+}
+
+// Reads the result word of channel_number and starts a conversion of
+// next_channel_number in back-to-back frames of one SPI transaction, so the ADC
+// restarts as soon as the previous result is out of the chip
+uint32_t get_raw_result_and_convert(uint8_t chip_select, uint8_t channel_number, uint8_t next_channel_number)
+{
+    uint16_t start_address = get_start_address(CONVERSION_RESULT_MEMORY_BASE, channel_number);
+    uint32_t raw_data = 0;
+    uint8_t i;
+    SPISettings settings(1000000, MSBFIRST, SPI_MODE0);
+    SPI.beginTransaction(settings);
+
+    output_low(chip_select);
+    spi_port_transfer(READ_FROM_RAM);
+    spi_port_transfer(highByte(start_address));
+    spi_port_transfer(lowByte(start_address));
+    for (i = 0; i < 4; i++)
+        raw_data = (raw_data << 8) | spi_port_transfer(0);
+    output_high(chip_select);
+
+    output_low(chip_select);
+    spi_port_transfer(WRITE_TO_RAM);
+    spi_port_transfer(highByte(COMMAND_STATUS_REGISTER));
+    spi_port_transfer(lowByte(COMMAND_STATUS_REGISTER));
+    spi_port_transfer(CONVERSION_CONTROL_BYTE | next_channel_number);
+    output_high(chip_select);
+
+    SPI.endTransaction();
+    return raw_data;
+}
+
+// Sign-extends the 24-bit conversion result, giving the temperature in 1/1024 degrees
+int32_t raw_result_to_fixed(uint32_t raw_result)
+{
+    int32_t signed_data = raw_result & 0xFFFFFF;
+    if (signed_data & 0x800000)
+        signed_data = signed_data | 0xFF000000;
+    return signed_data;
+}
+
 float print_conversion_result(uint32_t raw_conversion_result, uint8_t channel_output)
 {
     int32_t signed_data = raw_conversion_result;
@@ -179,6 +225,17 @@ float print_conversion_result(uint32_t raw_conversion_result, uint8_t channel_ou
 //  Serial.println(voltage_or_resistance_result);
 //}
 
+// Raw voltage (thermocouple, diode, direct ADC) or resistance (RTD, thermistor) of the
+// last conversion on the channel, without printing it
+float get_voltage_or_resistance_result(uint8_t chip_select, uint8_t channel_number)
+{
+    int32_t raw_data;
+    uint16_t start_address = get_start_address(VOUT_CH_BASE, channel_number);
+
+    raw_data = transfer_four_bytes(chip_select, READ_FROM_RAM, start_address, 0);
+    return (float)raw_data / 1024;
+}
+
 //// Translate the fault byte into usable fault data and print it out
 void print_fault_data(uint8_t fault_byte)
 {
@@ -245,6 +302,27 @@ uint8_t transfer_byte(uint8_t chip_select, uint8_t ram_read_or_write, uint16_t s
     return rx[0];
 }
 
+// Transfers length bytes starting at start_address in a single SPI frame, using the
+// chip's address auto-increment. data is sent in RAM order (lowest address first); when
+// reading, it is overwritten with the bytes read back.
+void transfer_ram_block(uint8_t chip_select, uint8_t ram_read_or_write, uint16_t start_address, uint8_t* data, uint16_t length)
+{
+    uint16_t i;
+    SPISettings settings(1000000, MSBFIRST, SPI_MODE0);
+    SPI.beginTransaction(settings);
+    output_low(chip_select);
+
+    spi_port_transfer(ram_read_or_write);
+    spi_port_transfer(highByte(start_address));
+    spi_port_transfer(lowByte(start_address));
+
+    for (i = 0; i < length; i++)
+        data[i] = spi_port_transfer(data[i]);
+
+    output_high(chip_select);
+    SPI.endTransaction();
+}
+
 // ******************************
 // Misc support functions
 // ******************************
@@ -253,6 +331,19 @@ uint16_t get_start_address(uint16_t base_address, uint8_t channel_number)
     return base_address + 4 * (channel_number - 1);
 }
 
+// CRC-16/CCITT (polynomial 0x1021), pass 0xFFFF as crc to start a new checksum
+uint16_t crc16_ccitt(const uint8_t* data, uint16_t length, uint16_t crc)
+{
+    uint16_t i;
+    uint8_t bit;
+    for (i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
 bool is_number_in_array(uint8_t number, uint8_t* array, uint8_t array_length)
 // Find out if a number is an element in an array
 {
@@ -270,6 +361,19 @@ void setSpiSup(uint8_t spi_port)
     _spi_port = spi_port;
 }
 
+// Sends and receives one byte on the selected SPI port
+uint8_t spi_port_transfer(uint8_t tx)
+{
+    switch (_spi_port) {
+    case 1:
+        return SPI1.transfer(tx);
+    case 2:
+        return SPI2.transfer(tx);
+    default:
+        return SPI.transfer(tx);
+    }
+}
+
 ////// This function was pulled from LTC_SPI.cpp///////
 // Reads and sends a byte array
 void spi_transfer_block(uint8_t chip_select, uint8_t* tx, uint8_t* rx, uint8_t length)
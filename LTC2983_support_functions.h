@@ -73,19 +73,26 @@ void convert_channel(uint8_t chip_select, uint8_t channel_number);
 void wait_for_process_to_finish(uint8_t chip_select);
 
 float get_result(uint8_t chip_select, uint8_t channel_number, uint8_t channel_output);
+uint32_t get_raw_result(uint8_t chip_select, uint8_t channel_number);
+uint32_t get_raw_result_and_convert(uint8_t chip_select, uint8_t channel_number, uint8_t next_channel_number);
+int32_t raw_result_to_fixed(uint32_t raw_result);
 float print_conversion_result(uint32_t raw_conversion_result, uint8_t channel_output);
 //void read_voltage_or_resistance_results(uint8_t chip_select, uint8_t channel_number);
+float get_voltage_or_resistance_result(uint8_t chip_select, uint8_t channel_number);
 void print_fault_data(uint8_t fault_byte);
 void LTC_sleep(uint8_t chip_select);
 
 
 uint32_t transfer_four_bytes(uint8_t chip_select, uint8_t read_or_write, uint16_t start_address, uint32_t input_data);
 uint8_t transfer_byte(uint8_t chip_select, uint8_t read_or_write, uint16_t start_address, uint8_t input_data);
+void transfer_ram_block(uint8_t chip_select, uint8_t read_or_write, uint16_t start_address, uint8_t *data, uint16_t length);
 
 uint16_t get_start_address(uint16_t base_address, uint8_t channel_number);
+uint16_t crc16_ccitt(const uint8_t *data, uint16_t length, uint16_t crc);
 bool is_number_in_array(uint8_t number, uint8_t *array, uint8_t array_length);
 
 void setSpiSup(uint8_t spi_port);
+uint8_t spi_port_transfer(uint8_t tx);
 
 //This function was pulled from LT_SPI.H//////
 void spi_transfer_block(uint8_t chip_select,     //!< Chip select pin
@@ -15,6 +15,8 @@ All rights reserved.
 
 */
 
+#ifndef LTC2983_TABLE_COEFFS_H
+#define LTC2983_TABLE_COEFFS_H
 
 #include <stdint.h>
 
@@ -32,3 +34,4 @@ struct channel_table
   uint8_t is_a_temperature_measurement;
 };
 
+#endif